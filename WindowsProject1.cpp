@@ -12,24 +12,67 @@
 // ==========================================
 // 1. ӿ Manifest 
 // ==========================================
+// ֻ Windows ϱ. ƽ̨,  SCHEDULER_BENCH ʱ, ļĩβ޽ main (׼)
+#if defined(_WIN32) && !defined(SCHEDULER_BENCH)
+#define SCHEDULER_GUI 1
+#endif
+
+#ifdef _WIN32
 #pragma comment(linker,"\"/manifestdependency:type='win32' name='Microsoft.Windows.Common-Controls' version='6.0.0.0' processorArchitecture='*' publicKeyToken='6595b64144ccf1df' language='*'\"")
 
+#ifdef SCHEDULER_GUI
 #pragma comment(linker, "/SUBSYSTEM:WINDOWS")
+#endif
 #pragma comment(lib, "user32.lib")
 #pragma comment(lib, "gdi32.lib")
 #pragma comment(lib, "comctl32.lib")
+#pragma comment(lib, "ws2_32.lib")
+#endif
 
 #define _CRT_SECURE_NO_WARNINGS
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600     // WSAPoll, CreateWaitableTimerExW, б (ɰ mingw Ĭϸ)
+#endif
 
+#ifdef _WIN32
 #include <windows.h>
 #include <commctrl.h> 
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <cerrno>
+#ifdef __linux__
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#endif
+extern char** environ;
+#endif
 #include <string>
 #include <vector>
 #include <list>
+#include <set>
 #include <mutex>
+#include <condition_variable>
 #include <thread>
+#include <atomic>
+#include <deque>
+#include <queue>
 #include <fstream>
 #include <memory>
 #include <chrono>
@@ -38,16 +81,54 @@
 #include <random>
 #include <iomanip>
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
 #include <stdexcept> 
+#include <new>
+#include <future>
+#include <coroutine>
+#include <utility>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+#include <climits>
+#include <cmath>
+#include <bit>
+#include <charconv>
+#include <string_view>
+#include <array>
+#include <filesystem>
+
+#ifndef _WIN32
+// POSIX ֻ localtime_r (˳෴)
+static inline int localtime_s(struct tm* out, const time_t* t) { return localtime_r(t, out) ? 0 : errno; }
+#endif
+
+// SIMD ·: MSVC /arch:AVX2  GCC/Clang -mavx2 (-mfma) ʱ, ߱ʵ
+#if defined(__AVX2__)
+#include <immintrin.h>
+#if defined(__FMA__) || defined(_MSC_VER)
+#define GEMM_USE_AVX2 1
+#endif
+#endif
+
+// CRC-32C Ӳָ: SSE4.2 (MSVC  /arch:AVX Ϊ׼),  x64
+#if (defined(__SSE4_2__) || (defined(_MSC_VER) && defined(__AVX__))) && (defined(__x86_64__) || defined(_M_X64))
+#include <nmmintrin.h>
+#define CRC32C_USE_SSE42 1
+#endif
 
 using namespace std;
 
 // ==========================================
 // ȫֳ ID
 // ==========================================
-#define WM_UPDATE_LOG (WM_USER + 1)
 #define WM_UPDATE_LIST (WM_USER + 2)
-#define WM_UPDATE_DATA (WM_USER + 3)
+
+#define ID_TIMER_SINK 1
+#define SINK_REFRESH_MS 100
 
 enum {
     ID_BTN_A = 101, ID_BTN_B, ID_BTN_C, ID_BTN_D, ID_BTN_E,
@@ -59,396 +140,6075 @@ enum {
     ID_BTN_CLEAR_DATA,
     ID_EDIT_LOG,
     ID_EDIT_DATA,
-    ID_LIST_TASKS
+    ID_LIST_TASKS,
+    ID_BTN_A_INCR   // ׷ĩβ: ťҲǳ־û kind, бŲܱ
 };
 
+#ifdef _WIN32
 HWND hGlobalWnd = NULL;
 HFONT hFontUI = NULL;
 HFONT hFontBold = NULL;
 HFONT hFontLog = NULL;
 HBRUSH hBrushSys = NULL;
+#endif
 
 // ==========================================
 // ־ϵͳ
 // ==========================================
+// ־: Block ߵȴλ; Drop 
+enum class LogOverflow { Block, Drop };
+
+struct LogConfig {
+    bool async = true;                                         // false: ߳ͬд벢ˢ
+    size_t queueCapacity = 8192;                               // λ, ȡ 2 
+    LogOverflow overflow = LogOverflow::Block;
+    chrono::milliseconds flushInterval = chrono::milliseconds(200);
+    size_t maxFileBytes = 10 * 1024 * 1024;                    // 0: Сת
+    chrono::minutes rotateEvery = chrono::minutes(0);          // 0: ʱת
+    int keepFiles = 5;                                         //  scheduler.log.1 .. .N
+};
+
+// н MPSC λ (Vyukov Ų):  CAS , һ߳
+template<class T>
+class MpscRing {
+    struct Cell {
+        atomic<size_t> seq;
+        T data;
+    };
+    unique_ptr<Cell[]> cells;
+    size_t mask;
+    atomic<size_t> enqueuePos{ 0 };
+    size_t dequeuePos = 0;
+
+public:
+    explicit MpscRing(size_t capacity) {
+        size_t n = 2;
+        while (n < capacity) n <<= 1;
+        cells.reset(new Cell[n]);
+        mask = n - 1;
+        for (size_t i = 0; i < n; ++i) cells[i].seq.store(i, memory_order_relaxed);
+    }
+
+    bool TryPush(T&& v) {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        while (true) {
+            Cell& c = cells[pos & mask];
+            size_t seq = c.seq.load(memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if (dif == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    c.data = move(v);
+                    c.seq.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if (dif < 0) {
+                return false;
+            }
+            else {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // ̵߳
+    bool TryPop(T& out) {
+        Cell& c = cells[dequeuePos & mask];
+        if (c.seq.load(memory_order_acquire) != dequeuePos + 1) return false;
+        out = move(c.data);
+        c.seq.store(dequeuePos + mask + 1, memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+};
+
 class LogWriter {
+    struct Record {
+        chrono::system_clock::time_point time;
+        string msg;
+    };
+
     ofstream logFile;
     mutex logMutex;
+    LogConfig config;
+    unique_ptr<MpscRing<Record>> ring;
+    thread flusher;
+    atomic<bool> stopping{ false };
+    atomic<bool> flusherIdle{ false };
+    mutex wakeMutex;
+    condition_variable wakeCv;
+    atomic<uint64_t> dropped{ 0 };
+    atomic<uint64_t> written{ 0 };
+
+    size_t fileBytes = 0;
+    chrono::system_clock::time_point fileOpened;
+    time_t stampSecond = -1;
+    char stamp[32] = {};
+
     LogWriter() {
+        OpenFile();
+        Start();
+    }
+
+    void OpenFile() {
         logFile.open("scheduler.log", ios::app);
+        logFile.seekp(0, ios::end);
+        fileBytes = logFile.is_open() ? (size_t)logFile.tellp() : 0;
+        fileOpened = chrono::system_clock::now();
+    }
+
+    // scheduler.log -> .1 -> .2 ...  keepFiles ɾ
+    void Rotate() {
+        logFile.close();
+        string base = "scheduler.log";
+        remove((base + "." + to_string(config.keepFiles)).c_str());
+        for (int i = config.keepFiles - 1; i >= 1; --i)
+            rename((base + "." + to_string(i)).c_str(), (base + "." + to_string(i + 1)).c_str());
+        if (config.keepFiles > 0) rename(base.c_str(), (base + ".1").c_str());
+        else remove(base.c_str());
+        OpenFile();
+    }
+
+    bool NeedRotate(chrono::system_clock::time_point now) const {
+        if (config.maxFileBytes && fileBytes >= config.maxFileBytes) return true;
+        return config.rotateEvery.count() > 0 && now - fileOpened >= config.rotateEvery;
+    }
+
+    // ͬһڸѸʽʱ,  localtime_s
+    void AppendLine(string& out, chrono::system_clock::time_point tp, const string& msg) {
+        time_t sec = chrono::system_clock::to_time_t(tp);
+        if (sec != stampSecond) {
+            struct tm t; localtime_s(&t, &sec);
+            strftime(stamp, sizeof(stamp), "[%Y-%m-%d %H:%M:%S] ", &t);
+            stampSecond = sec;
+        }
+        out += stamp;
+        out += msg;
+        out += '\n';
+    }
+
+    void WriteBatch(const string& batch, bool flush) {
+        if (batch.empty() && !flush) return;
+        lock_guard<mutex> lock(logMutex);
+        if (!batch.empty()) {
+            if (NeedRotate(chrono::system_clock::now())) Rotate();
+            if (logFile.is_open()) logFile.write(batch.data(), (streamsize)batch.size());
+            fileBytes += batch.size();
+        }
+        if (flush && logFile.is_open()) logFile.flush();
+    }
+
+    // ̨߳: ʽ, һд;  flushInterval ˢ
+    void FlushLoop() {
+        string batch;
+        batch.reserve(256 * 1024);
+        Record rec;
+        auto lastFlush = chrono::steady_clock::now();
+        uint64_t reportedDrops = 0;
+        while (true) {
+            size_t n = 0;
+            while (n < 4096 && ring->TryPop(rec)) {
+                AppendLine(batch, rec.time, rec.msg);
+                ++n;
+            }
+            uint64_t d = dropped.load(memory_order_relaxed);
+            if (d != reportedDrops) {
+                AppendLine(batch, chrono::system_clock::now(), "[LogWriter] " + to_string(d - reportedDrops) + " message(s) dropped (queue full)");
+                reportedDrops = d;
+            }
+            written += n;
+
+            auto now = chrono::steady_clock::now();
+            bool flushDue = now - lastFlush >= config.flushInterval;
+            if (!batch.empty() || flushDue) {
+                WriteBatch(batch, flushDue);
+                batch.clear();
+                if (flushDue) lastFlush = now;
+            }
+            if (n > 0) continue;
+            if (stopping.load()) break;
+
+            unique_lock<mutex> lock(wakeMutex);
+            flusherIdle = true;
+            wakeCv.wait_for(lock, config.flushInterval);
+            flusherIdle = false;
+        }
+        while (ring->TryPop(rec)) AppendLine(batch, rec.time, rec.msg);
+        WriteBatch(batch, true);
     }
+
+    void Start() {
+        if (!config.async) return;
+        ring = make_unique<MpscRing<Record>>(config.queueCapacity);
+        stopping = false;
+        flusher = thread(&LogWriter::FlushLoop, this);
+    }
+
+    void StopFlusher() {
+        if (!flusher.joinable()) return;
+        stopping = true;
+        wakeCv.notify_one();
+        flusher.join();
+        ring.reset();
+    }
+
+    void WakeFlusher() {
+        if (flusherIdle.load(memory_order_relaxed)) {
+            lock_guard<mutex> lock(wakeMutex);
+            wakeCv.notify_one();
+        }
+    }
+
 public:
     static LogWriter& Instance() { static LogWriter i; return i; }
-    ~LogWriter() { if (logFile.is_open()) logFile.close(); }
+    ~LogWriter() {
+        StopFlusher();
+        if (logFile.is_open()) logFile.close();
+    }
 
-    void Write(const string& msg) {
-        lock_guard<mutex> lock(logMutex);
-        auto now = chrono::system_clock::to_time_t(chrono::system_clock::now());
-        struct tm t; localtime_s(&t, &now);
-        if (logFile.is_open()) {
-            logFile << put_time(&t, "[%Y-%m-%d %H:%M:%S] ") << msg << endl;
+    // ſյǰк; Ӧ׶Ρ߳д־ʱ
+    void Configure(const LogConfig& cfg) {
+        StopFlusher();
+        {
+            lock_guard<mutex> lock(logMutex);
+            config = cfg;
         }
+        Start();
     }
-};
 
-void Log(const string& msg) {
-    LogWriter::Instance().Write(msg);
-    string* pMsg = new string(msg);
-    if (hGlobalWnd) PostMessageA(hGlobalWnd, WM_UPDATE_LOG, 0, (LPARAM)pMsg);
-}
+    void Write(const string& msg) {
+        if (!config.async || !ring) {
+            lock_guard<mutex> lock(logMutex);
+            auto now = chrono::system_clock::now();
+            if (NeedRotate(now)) Rotate();
+            string line;
+            AppendLine(line, now, msg);
+            if (logFile.is_open()) logFile << line << flush;
+            fileBytes += line.size();
+            ++written;
+            return;
+        }
 
-void LogData(const string& data) {
-    string* pMsg = new string(data);
-    if (hGlobalWnd) PostMessageA(hGlobalWnd, WM_UPDATE_DATA, 0, (LPARAM)pMsg);
-}
+        Record rec{ chrono::system_clock::now(), msg };
+        while (!ring->TryPush(move(rec))) {
+            if (config.overflow == LogOverflow::Drop) { ++dropped; return; }
+            WakeFlusher();
+            this_thread::yield();
+        }
+        WakeFlusher();
+    }
+
+    uint64_t DroppedCount() const { return dropped.load(); }
+    uint64_t WrittenCount() const { return written.load(); }
+};
 
 // ==========================================
-// ϵͳӿ
+//  (System Log / Data Board)
 // ==========================================
-class ITask {
+// λ: ʱɵһ. λַ,
+// ̬ Push ٷڴ; Drain ˢ½һȡȫ.
+class SinkChannel {
+    mutex m;
+    vector<string> slots;
+    size_t head = 0;
+    size_t count = 0;
+    uint64_t overwritten = 0;
+    const char* lineEnd;
+
 public:
-    virtual string GetName() const = 0;
-    virtual void Execute() = 0;
-    virtual ~ITask() = default;
+    SinkChannel(size_t capacity, const char* lineEnd) : slots(max<size_t>(1, capacity)), lineEnd(lineEnd) {}
+
+    void Push(const char* data, size_t len) {
+        lock_guard<mutex> lock(m);
+        size_t idx = (head + count) % slots.size();
+        if (count == slots.size()) {
+            head = (head + 1) % slots.size();
+            ++overwritten;
+        }
+        else {
+            ++count;
+        }
+        slots[idx].assign(data, len);
+        slots[idx] += lineEnd;
+    }
+
+    // ѴϢƴӽ out (, ), ȡ
+    size_t Drain(string& out) {
+        out.clear();
+        lock_guard<mutex> lock(m);
+        if (overwritten) {
+            out += "... ";
+            out += to_string(overwritten);
+            out += " message(s) skipped ...\r\n";
+            overwritten = 0;
+        }
+        size_t n = count;
+        for (; count > 0; --count) {
+            out += slots[head];
+            head = (head + 1) % slots.size();
+        }
+        return n;
+    }
 };
 
-// --- Task A: ʵļ ---
-class TaskBackup : public ITask {
-public:
-    string GetName() const override { return "Task A: File Backup"; }
-    void Execute() override {
-        auto now = chrono::system_clock::to_time_t(chrono::system_clock::now());
-        struct tm t; localtime_s(&t, &now);
-        stringstream ss; ss << "backup_" << put_time(&t, "%Y%m%d_%H%M%S") << ".zip";
-        string zipName = ss.str();
+// ֻ maxLines Ҳ maxBytes ֽڵı, ¼ÿгԱͷü
+class BoundedText {
+    deque<size_t> lineLens;
+    size_t partial = 0; // ĩβδԻнһ
+    size_t bytes = 0;
+    size_t maxLines;
+    size_t maxBytes;
 
-        string srcDir = "C:\\Data";
-        string destBase = "D:\\Backup";
-        string destFile = destBase + "\\" + zipName;
+public:
+    BoundedText(size_t maxLines, size_t maxBytes) : maxLines(maxLines), maxBytes(maxBytes) {}
 
-        Log("A: Init backup sequence...");
+    void Reset() { lineLens.clear(); partial = 0; bytes = 0; }
+    size_t Bytes() const { return bytes; }
+    size_t Lines() const { return lineLens.size() + (partial ? 1 : 0); }
 
-        if (GetFileAttributesA(srcDir.c_str()) == INVALID_FILE_ATTRIBUTES) {
-            Log("A: Creating C:\\Data source...");
-            CreateDirectoryA(srcDir.c_str(), NULL);
-            ofstream ofs(srcDir + "\\test_file.txt");
-            ofs << "Test file for Project 3." << endl;
-            ofs.close();
+    // ׷һı, ΪҪͷɾֽ
+    size_t Append(const string& chunk) {
+        for (char c : chunk) {
+            ++partial;
+            if (c == '\n') { lineLens.push_back(partial); partial = 0; }
         }
-
-        if (GetFileAttributesA(destBase.c_str()) == INVALID_FILE_ATTRIBUTES) {
-            if (!CreateDirectoryA(destBase.c_str(), NULL)) {
-                Log("A: D:\\Backup failed. Using C:\\Backup...");
-                destBase = "C:\\Backup";
-                destFile = destBase + "\\" + zipName;
-                CreateDirectoryA(destBase.c_str(), NULL);
-            }
+        bytes += chunk.size();
+        size_t trim = 0;
+        while (!lineLens.empty() && (Lines() > maxLines || bytes > maxBytes)) {
+            trim += lineLens.front();
+            bytes -= lineLens.front();
+            lineLens.pop_front();
         }
+        return trim;
+    }
+};
 
-        Log("A: Zip -> " + destFile);
+enum class SinkChannelId { Log, Data };
 
-        string cmd = "powershell -WindowStyle Hidden -Command \"Compress-Archive -Path '" + srcDir + "\\*' -DestinationPath '" + destFile + "' -Force\"";
-        UINT res = WinExec(cmd.c_str(), SW_HIDE);
+// : ֻд뻷λ, Flush ÿˢ½ĵһ, ı Present
+class OutputSink {
+    SinkChannel logChannel{ 4096, "\r\n" };
+    SinkChannel dataChannel{ 256, "" };
+    BoundedText logText{ 2000, 256 * 1024 };
+    BoundedText dataText{ 3000, 512 * 1024 };
+    string batch;
 
-        if (res > 31) {
-            this_thread::sleep_for(chrono::seconds(2));
-            if (GetFileAttributesA(destFile.c_str()) != INVALID_FILE_ATTRIBUTES) {
-                Log("A: Success! File saved.");
-            }
-            else {
-                Log("A: Cmd sent, verify manually.");
-            }
+    BoundedText& Text(SinkChannelId ch) { return ch == SinkChannelId::Log ? logText : dataText; }
+
+protected:
+    // ׷ text; ׷ǰɾȥݿͷ trimFront ֽ (ܳг, ʱͬ text Ŀͷһɾ)
+    virtual void Present(SinkChannelId ch, const string& text, size_t trimFront) = 0;
+    virtual void Replace(SinkChannelId ch, const string& text) = 0;
+
+public:
+    virtual ~OutputSink() = default;
+
+    void PushLog(const string& msg) { logChannel.Push(msg.data(), msg.size()); }
+    void PushData(const string& text) { dataChannel.Push(text.data(), text.size()); }
+
+    void Flush() {
+        if (logChannel.Drain(batch)) Present(SinkChannelId::Log, batch, logText.Append(batch));
+        if (dataChannel.Drain(batch)) Present(SinkChannelId::Data, batch, dataText.Append(batch));
+    }
+
+    void Reset(SinkChannelId ch, const string& text) {
+        Text(ch).Reset();
+        Text(ch).Append(text);
+        Replace(ch, text);
+    }
+};
+
+// ޽ʵ: ֱάַ,  Linux  GUI  / ޽Ļ׼
+class HeadlessSink : public OutputSink {
+    string logView;
+    string dataView;
+
+protected:
+    void Present(SinkChannelId ch, const string& text, size_t trimFront) override {
+        string& view = ch == SinkChannelId::Log ? logView : dataView;
+        if (trimFront >= view.size()) {
+            view.assign(text, min(text.size(), trimFront - view.size()), string::npos);
         }
         else {
-            Log("A: Failed to launch PowerShell.");
+            view.erase(0, trimFront);
+            view += text;
         }
     }
-};
+    void Replace(SinkChannelId ch, const string& text) override { (ch == SinkChannelId::Log ? logView : dataView) = text; }
 
-// --- Task B: Matrix Calc ---
-class TaskMatrix : public ITask {
-    int runCount = 0;
 public:
-    string GetName() const override { return "Task B: Matrix Calc (200x200)"; }
-    void Execute() override {
-        Log("B: Generating Matrix...");
+    const string& View(SinkChannelId ch) const { return ch == SinkChannelId::Log ? logView : dataView; }
+};
 
-        auto start = chrono::high_resolution_clock::now();
-        int N = 200;
-        vector<vector<double>> A(N, vector<double>(N));
+#ifdef _WIN32
+// ༭ʵ: ֻڽ߳ (WM_TIMER)  Flush
+class EditControlSink : public OutputSink {
+    HWND hLog;
+    HWND hData;
 
-        for (int i = 0; i < N; ++i)
-            for (int j = 0; j < N; ++j) {
-                A[i][j] = (double)(rand() % 100) / 10.0;
+protected:
+    void Present(SinkChannelId ch, const string& text, size_t trimFront) override {
+        HWND h = ch == SinkChannelId::Log ? hLog : hData;
+        size_t len = (size_t)GetWindowTextLengthA(h);
+        if (trimFront >= len) {
+            SetWindowTextA(h, text.c_str() + min(text.size(), trimFront - len));
+        }
+        else {
+            if (trimFront) {
+                SendMessageA(h, EM_SETSEL, 0, (LPARAM)trimFront);
+                SendMessageA(h, EM_REPLACESEL, 0, (LPARAM)"");
+                len -= trimFront;
             }
+            SendMessageA(h, EM_SETSEL, (WPARAM)len, (LPARAM)len);
+            SendMessageA(h, EM_REPLACESEL, 0, (LPARAM)text.c_str());
+        }
+        SendMessage(h, WM_VSCROLL, SB_BOTTOM, 0);
+    }
+    void Replace(SinkChannelId ch, const string& text) override {
+        SetWindowTextA(ch == SinkChannelId::Log ? hLog : hData, text.c_str());
+    }
 
-        // --- ݴ ---
-        stringstream ss;
-        ss << "\r\n";
+public:
+    EditControlSink(HWND hLog, HWND hData) : hLog(hLog), hData(hData) {}
+};
+#endif
 
-        string sep(67, '=');
-        ss << sep << "\r\n";
-        ss << " TASK B: MATRIX PREVIEW (Top-Left 10x10 Block) - Iteration: " << runCount++ << "\r\n";
-        ss << sep << "\r\n";
+atomic<OutputSink*> g_sink{ nullptr };
 
-        ss << "      ";
-        for (int j = 0; j < 10; ++j) ss << "+-----";
-        ss << "+\r\n";
+void Log(const string& msg) {
+    LogWriter::Instance().Write(msg);
+    if (OutputSink* sink = g_sink.load()) sink->PushLog(msg);
+}
 
-        for (int i = 0; i < 10; ++i) {
-            ss << " R" << setw(2) << i << "  ";
-            for (int j = 0; j < 10; ++j) {
-                ss << "|" << fixed << setprecision(1) << setw(5) << A[i][j];
-            }
-            ss << "|\r\n";
-            ss << "      ";
-            for (int j = 0; j < 10; ++j) ss << "+-----";
-            ss << "+\r\n";
-        }
-        ss << " (... 200x200 Full Data Hidden ...)\r\n";
-        LogData(ss.str());
+void LogData(const string& data) {
+    if (OutputSink* sink = g_sink.load()) sink->PushData(data);
+}
 
-        auto end = chrono::high_resolution_clock::now();
-        chrono::duration<double, milli> elapsed = end - start;
+// ==========================================
+// 
+// ==========================================
+// 4 · xoshiro256**: ״ַ̬ (s[][·]) , ʱ 4 ͬʱƽ.
+// ·ͬһӾ jump (2^128 ) õ, ص.  5 /  9 дλӷ,  AVX2 .
+class Xoshiro256x4 {
+    alignas(32) uint64_t s[4][4];
 
-        stringstream logMsg;
-        logMsg << "B: Calc finished in " << fixed << setprecision(2) << elapsed.count() << " ms.";
-        Log(logMsg.str());
+    static uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    static uint64_t SplitMix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
     }
-};
 
-// --- Task C: HTTP ---
-class TaskHttp : public ITask {
-public:
-    string GetName() const override { return "Task C: HTTP GET"; }
-    void Execute() override {
-        Log("C: Requesting data...");
-        this_thread::sleep_for(chrono::milliseconds(800));
-        Log("C: Data received.");
+    static uint64_t NextScalar(uint64_t st[4]) {
+        uint64_t result = Rotl(st[1] * 5, 7) * 9;
+        uint64_t t = st[1] << 17;
+        st[2] ^= st[0]; st[3] ^= st[1]; st[1] ^= st[2]; st[0] ^= st[3];
+        st[2] ^= t;
+        st[3] = Rotl(st[3], 45);
+        return result;
+    }
+
+    static void Jump(uint64_t st[4]) {
+        static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+        uint64_t acc[4] = {};
+        for (uint64_t j : JUMP)
+            for (int b = 0; b < 64; ++b) {
+                if (j & (1ULL << b))
+                    for (int w = 0; w < 4; ++w) acc[w] ^= st[w];
+                NextScalar(st);
+            }
+        for (int w = 0; w < 4; ++w) st[w] = acc[w];
     }
-};
 
-// --- Task D: Reminder ---
-class TaskReminder : public ITask {
 public:
-    string GetName() const override { return "Task D: Reminder"; }
-    void Execute() override {
-        thread([]() {
-            MessageBoxA(hGlobalWnd, "Ϣ 5 ", "", MB_OK | MB_ICONINFORMATION | MB_SYSTEMMODAL);
-            }).detach();
-        Log("D: Popup displayed.");
+    explicit Xoshiro256x4(uint64_t seed = 0) { Seed(seed); }
+
+    void Seed(uint64_t seed) {
+        uint64_t st[4];
+        for (auto& w : st) w = SplitMix64(seed);
+        for (int lane = 0; lane < 4; ++lane) {
+            for (int w = 0; w < 4; ++w) s[w][lane] = st[w];
+            Jump(st);
+        }
+    }
+
+    //  ·0, ·1, ·2, ·3, ·0 ... ˳, n Ϊ 4 ı
+    void Fill(uint64_t* out, size_t n) {
+#if defined(__AVX2__)
+        __m256i s0 = _mm256_load_si256((const __m256i*)s[0]);
+        __m256i s1 = _mm256_load_si256((const __m256i*)s[1]);
+        __m256i s2 = _mm256_load_si256((const __m256i*)s[2]);
+        __m256i s3 = _mm256_load_si256((const __m256i*)s[3]);
+        for (size_t i = 0; i < n; i += 4) {
+            __m256i x5 = _mm256_add_epi64(_mm256_slli_epi64(s1, 2), s1);
+            __m256i r = _mm256_or_si256(_mm256_slli_epi64(x5, 7), _mm256_srli_epi64(x5, 57));
+            __m256i result = _mm256_add_epi64(_mm256_slli_epi64(r, 3), r);
+            _mm256_storeu_si256((__m256i*)(out + i), result);
+            __m256i t = _mm256_slli_epi64(s1, 17);
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+        }
+        _mm256_store_si256((__m256i*)s[0], s0);
+        _mm256_store_si256((__m256i*)s[1], s1);
+        _mm256_store_si256((__m256i*)s[2], s2);
+        _mm256_store_si256((__m256i*)s[3], s3);
+#else
+        for (size_t i = 0; i < n; i += 4) {
+            for (int k = 0; k < 4; ++k) {
+                uint64_t x5 = (s[1][k] << 2) + s[1][k];
+                uint64_t r = Rotl(x5, 7);
+                out[i + k] = (r << 3) + r;
+            }
+            for (int k = 0; k < 4; ++k) {
+                uint64_t t = s[1][k] << 17;
+                s[2][k] ^= s[0][k];
+                s[3][k] ^= s[1][k];
+                s[1][k] ^= s[2][k];
+                s[0][k] ^= s[3][k];
+                s[2][k] ^= t;
+                s[3][k] = Rotl(s[3][k], 45);
+            }
+        }
+#endif
     }
 };
 
-// --- Task E: Stats ---
-class TaskStats : public ITask {
-public:
-    string GetName() const override { return "Task E: Random Stats"; }
-    void Execute() override {
-        Log("E: Generating 1000 numbers...");
+// : ɵڲ, ṩ / ʵֲ. ̰߳ȫ, ÿ̸߳һ.
+class FastRng {
+    static constexpr size_t BUF = 256;
+    Xoshiro256x4 core;
+    uint64_t buf[BUF];
+    size_t pos = BUF;
+
+    // Lemire ˷-λӳ䵽 [0, range), ܾƫ. range == 0 ʾ 2^32 
+    uint32_t Bounded(uint32_t x, uint32_t range, uint32_t threshold) {
+        if (range == 0) return x;
+        uint64_t m = (uint64_t)x * range;
+        while ((uint32_t)m < threshold) m = (uint64_t)(uint32_t)Next() * range;
+        return (uint32_t)(m >> 32);
+    }
 
-        random_device rd; mt19937 gen(rd());
-        uniform_int_distribution<> dis(0, 100);
-        vector<int> nums;
-        double sum = 0;
+public:
+    explicit FastRng(uint64_t seed = 0) : core(seed) {}
 
-        stringstream ss;
-        ss << "\r\n";
+    void Seed(uint64_t seed) { core.Seed(seed); pos = BUF; }
 
-        string sep(84, '=');
-        ss << sep << "\r\n";
-        ss << " TASK E: DATA MATRIX (20 Columns x 50 Rows)\r\n";
-        ss << sep << "\r\n";
+    uint64_t Next() {
+        if (pos == BUF) { core.Fill(buf, BUF); pos = 0; }
+        return buf[pos++];
+    }
 
-        string lineBorder = "+" + string(82, '-') + "+";
-        ss << lineBorder << "\r\n";
+    void Fill(uint64_t* out, size_t n) {
+        size_t bulk = n & ~(size_t)3;
+        core.Fill(out, bulk);
+        for (size_t i = bulk; i < n; ++i) out[i] = Next();
+    }
 
-        for (int i = 0; i < 1000; ++i) {
-            int n = dis(gen);
-            nums.push_back(n);
-            sum += n;
+    // [lo, hi] 䳤; [INT_MIN, INT_MAX] ʱΪ 0
+    static uint32_t Range(int lo, int hi) {
+        if (hi < lo) throw invalid_argument("FastRng: hi < lo");
+        return (uint32_t)((int64_t)hi - lo + 1);
+    }
+    static uint32_t Threshold(uint32_t range) { return range ? (0u - range) % range : 0; }
 
-            if (i % 20 == 0) ss << "| ";
-            ss << setw(3) << n << " ";
-            if ((i + 1) % 20 == 0) ss << " |\r\n";
+    // [lo, hi] ڵľ, ÿ 64 λ 32 λʹ
+    void FillInt(int* out, size_t n, int lo, int hi) {
+        uint32_t range = Range(lo, hi);
+        uint32_t threshold = Threshold(range);
+        uint64_t chunk[BUF];
+        while (n > 0) {
+            size_t pairs = min((n + 1) / 2, BUF);
+            Fill(chunk, pairs);
+            for (size_t i = 0; i < pairs && n > 0; ++i) {
+                *out++ = (int)((uint32_t)lo + Bounded((uint32_t)chunk[i], range, threshold)); --n;
+                if (n > 0) { *out++ = (int)((uint32_t)lo + Bounded((uint32_t)(chunk[i] >> 32), range, threshold)); --n; }
+            }
         }
-        ss << lineBorder << "\r\n";
+    }
 
-        double mean = sum / 1000.0;
-        double variance = 0;
-        for (int n : nums) variance += (n - mean) * (n - mean);
-        variance /= 1000.0;
+    // [lo, hi) ڵľʵ (53 λ)
+    void FillReal(double* out, size_t n, double lo, double hi) {
+        uint64_t chunk[BUF];
+        double scale = (hi - lo) * (1.0 / 9007199254740992.0);
+        while (n > 0) {
+            size_t c = min(n, BUF);
+            Fill(chunk, c);
+            for (size_t i = 0; i < c; ++i) out[i] = lo + (double)(chunk[i] >> 11) * scale;
+            out += c;
+            n -= c;
+        }
+    }
 
-        ss << "  [STATISTICS REPORT]\r\n";
-        ss << "  > Count:    1000\r\n";
-        ss << "  > Mean:     " << fixed << setprecision(2) << mean << "\r\n";
-        ss << "  > Variance: " << variance << "\r\n";
+    int UniformInt(int lo, int hi) {
+        uint32_t range = Range(lo, hi);
+        return (int)((uint32_t)lo + Bounded((uint32_t)Next(), range, Threshold(range)));
+    }
 
-        LogData(ss.str());
-        Log("E: Stats computed (See Data Board).");
+    double UniformReal(double lo, double hi) {
+        return lo + (double)(Next() >> 11) * (1.0 / 9007199254740992.0) * (hi - lo);
     }
 };
 
-// --- Task F: Chaos ---
-class TaskChaos : public ITask {
+// ÿ߳һ FastRng. ȷӺ, Acquire(streamKey) ᰴ (, streamKey) ²,
+// ͬһ streamKey ĸ worker жõͬ, ӶԸĳĳһ.
+class RandomService {
+    static atomic<uint64_t>& SeedSlot() { static atomic<uint64_t> seed{ 0 }; return seed; }
+
+    static uint64_t Mix(uint64_t a, uint64_t b) {
+        uint64_t x = a ^ (b + 0x9E3779B97F4A7C15ULL + (a << 6) + (a >> 2));
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
 public:
-    string GetName() const override { return "Task F: CHAOS (FREEZE)"; }
-    void Execute() override {
-        Log("F: Critical Error! Throwing Exception...");
-        throw runtime_error("CORE DUMP: MEMORY VIOLATION");
+    // seed = 0 رȷģʽ
+    static void SetDeterministicSeed(uint64_t seed) { SeedSlot() = seed; }
+    static uint64_t DeterministicSeed() { return SeedSlot().load(); }
+
+    static FastRng& ThreadLocal() {
+        static thread_local FastRng rng(Mix(random_device{}(), hash<thread::id>{}(this_thread::get_id())));
+        return rng;
     }
+
+    // streamKey һ,  StreamKey
+    static FastRng& Acquire(uint64_t streamKey) {
+        FastRng& rng = ThreadLocal();
+        uint64_t seed = DeterministicSeed();
+        if (seed) rng.Seed(Mix(seed, streamKey));
+        return rng;
+    }
+
+    static uint64_t StreamKey(uint32_t kind, uint32_t run) { return ((uint64_t)kind << 32) | run; }
 };
 
 // ==========================================
-// 
+// ʽ
 // ==========================================
-struct ScheduledTask {
-    int id = 0;
-    shared_ptr<ITask> task = nullptr;
-    chrono::system_clock::time_point runTime = {};
-    bool isPeriodic = false;
-    chrono::milliseconds interval = chrono::milliseconds(0);
+//  to_chars ı: ÿ߳һ, ʱ, ̬ɱٷڴ.
+// ֵ setw ķʽҶ; βͳһΪ "\r\n" (༭Ҫ).
+class ReportBuffer {
+    string buf;
 
-    string GetTimeStr() {
-        auto t = chrono::system_clock::to_time_t(runTime);
-        struct tm tmInfo; localtime_s(&tmInfo, &t);
-        stringstream ss; ss << put_time(&tmInfo, "%H:%M:%S");
-        return ss.str();
+    ReportBuffer& Pad(const char* p, size_t len, int width) {
+        if (width > (int)len) buf.append((size_t)width - len, ' ');
+        buf.append(p, len);
+        return *this;
     }
-};
 
-class TaskScheduler {
-    list<shared_ptr<ScheduledTask>> taskList;
-    mutex listMutex;
-    condition_variable cv;
-    bool running = true;
-    thread workerThread;
-    int nextId = 1;
-    bool isFrozen = false;
+public:
+    ReportBuffer() { buf.reserve(64 * 1024); }
 
-    TaskScheduler() { workerThread = thread(&TaskScheduler::WorkerLoop, this); }
+    // ȡǰ̵߳Ļ岢
+    static ReportBuffer& Begin() {
+        static thread_local ReportBuffer rb;
+        rb.buf.clear();
+        return rb;
+    }
 
-    void RefreshUI() { if (hGlobalWnd) PostMessageA(hGlobalWnd, WM_UPDATE_LIST, 0, 0); }
+    const string& Str() const { return buf; }
 
-    void WorkerLoop() {
-        while (running) {
-            shared_ptr<ScheduledTask> currentTask = nullptr;
+    ReportBuffer& Text(string_view t) { buf.append(t.data(), t.size()); return *this; }
+    ReportBuffer& Repeat(char c, size_t n) { buf.append(n, c); return *this; }
+    ReportBuffer& Repeat(string_view t, size_t n) { for (size_t i = 0; i < n; ++i) Text(t); return *this; }
+    ReportBuffer& NewLine() { buf.append("\r\n", 2); return *this; }
 
-            {
-                unique_lock<mutex> lock(listMutex);
-                cv.wait(lock, [this] { return (!taskList.empty() && !isFrozen) || !running; });
+    ReportBuffer& Int(long long v, int width = 0) {
+        char tmp[24];
+        auto r = to_chars(tmp, tmp + sizeof(tmp), v);
+        return Pad(tmp, (size_t)(r.ptr - tmp), width);
+    }
 
-                if (!running) { lock.unlock(); break; }
-                if (isFrozen) continue;
+    ReportBuffer& UInt(unsigned long long v, int width = 0) {
+        char tmp[24];
+        auto r = to_chars(tmp, tmp + sizeof(tmp), v);
+        return Pad(tmp, (size_t)(r.ptr - tmp), width);
+    }
 
-                auto it = min_element(taskList.begin(), taskList.end(),
-                    [](const auto& a, const auto& b) { return a->runTime < b->runTime; });
+    // ȼ fixed << setprecision(precision) << setw(width)
+    ReportBuffer& Fixed(double v, int precision, int width = 0) {
+        char tmp[64];
+        auto r = to_chars(tmp, tmp + sizeof(tmp), v, chars_format::fixed, precision);
+        if (r.ec != errc()) return Pad("?", 1, width);
+        return Pad(tmp, (size_t)(r.ptr - tmp), width);
+    }
 
-                if (it != taskList.end()) {
-                    auto now = chrono::system_clock::now();
-                    if ((*it)->runTime <= now) {
-                        currentTask = *it;
-                        taskList.erase(it);
-                    }
-                    else {
-                        cv.wait_until(lock, (*it)->runTime);
-                        continue;
-                    }
-                }
-            }
+    // ʽ:  ( + ָ +  + ָ),  title صд
+    template<class F> ReportBuffer& Banner(size_t width, F title) {
+        NewLine().Repeat('=', width).NewLine();
+        title(*this);
+        return NewLine().Repeat('=', width).NewLine();
+    }
 
-            if (currentTask) {
-                RefreshUI();
-                try {
-                    currentTask->task->Execute();
-                }
-                catch (const std::exception& e) {
-                    string err = "SYSTEM FAILURE: " + string(e.what());
-                    Log(err);
-                    Log("!!! SYSTEM FROZEN !!!");
+    // ʽ: ˮƽ߿ "indent +-----+-----+"
+    ReportBuffer& GridRule(size_t indent, size_t cols, size_t cellWidth) {
+        Repeat(' ', indent);
+        for (size_t j = 0; j < cols; ++j) Text("+").Repeat('-', cellWidth);
+        return Text("+").NewLine();
+    }
 
-                    { lock_guard<mutex> lock(listMutex); isFrozen = true; }
-                    {
-                        unique_lock<mutex> lock(listMutex);
-                        cv.wait(lock, [this] { return !isFrozen || !running; });
-                    }
-                    Log(">>> SYSTEM RECOVERED. <<<");
-                }
+    // ʽ: ͳƱһ "  > Label  value"
+    ReportBuffer& Field(string_view label) { return Text("  > ").Text(label); }
+};
 
-                if (currentTask->isPeriodic && running && !isFrozen) {
-                    currentTask->runTime = chrono::system_clock::now() + currentTask->interval;
-                    { lock_guard<mutex> lock(listMutex); taskList.push_back(currentTask); }
-                    Log("Rescheduled: " + currentTask->task->GetName());
-                    cv.notify_one();
-                    RefreshUI();
-                }
-            }
+// ==========================================
+// ϵͳӿ
+// ==========================================
+// ص: failed Ϊ true ʱ error Ϊԭ
+using TaskDone = function<void(bool failed, const string& error)>;
+
+class ITask {
+public:
+    virtual string GetName() const = 0;
+    virtual void Execute() = 0;
+    // , ʱǡõһ done. Ĭڵǰִ߳ͬ Execute;
+    // 첽д˺, ⲿ¼ (ӽ˳) ߳ϵ done.
+    virtual void Start(TaskDone done) {
+        try {
+            Execute();
+        }
+        catch (const std::exception& e) {
+            done(true, e.what());
+            return;
         }
+        catch (...) {
+            done(true, "unknown exception");
+            return;
+        }
+        done(false, string());
     }
+    virtual ~ITask() = default;
+};
+
+// ==========================================
+// Դȡ (Task A)
+// ==========================================
+namespace fs = std::filesystem;
+
+// ִ fn(0..n-1), ߳Ҳ; һ쳣߳̽׳
+static void ParallelFor(size_t n, int threads, const function<void(size_t)>& fn) {
+    atomic<size_t> next{ 0 };
+    mutex errMutex;
+    exception_ptr err;
+    auto worker = [&] {
+        for (size_t i; (i = next.fetch_add(1)) < n;) {
+            try { fn(i); }
+            catch (...) {
+                lock_guard<mutex> lk(errMutex);
+                if (!err) err = current_exception();
+                next = n;
+            }
+        }
+    };
+    threads = (int)min<size_t>((size_t)max(1, threads), max<size_t>(1, n));
+    vector<thread> pool;
+    for (int i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    if (err) rethrow_exception(err);
+}
+
+// Դļ: · + 鵵 ('/' ָ, UTF-8) + ʱȡõĴС޸ʱ
+struct SourceFile {
+    fs::path source;
+    string name;
+    uint64_t size = 0;
+    int64_t mtime = 0;      // file_time_type ļ
+};
+
+// Ŀ¼: Ŀ¼Ϊ빲, ߳ȡһĿ¼о, Ŀ¼ٷŻض.
+// Ŀ¼ ( recursive_directory_iterator Ĭһ); .
+class SourceScanner {
+public:
+    static vector<SourceFile> Walk(const fs::path& root, int threads) {
+        if (!fs::is_directory(root)) throw runtime_error("source is not a directory: " + root.string());
+        mutex m;
+        condition_variable cv;
+        deque<fs::path> dirs{ root };
+        int busy = 0;
+        vector<SourceFile> files;
+
+        auto worker = [&] {
+            for (;;) {
+                fs::path dir;
+                {
+                    unique_lock<mutex> lk(m);
+                    cv.wait(lk, [&] { return !dirs.empty() || busy == 0; });
+                    if (dirs.empty()) return;
+                    dir = move(dirs.front());
+                    dirs.pop_front();
+                    ++busy;
+                }
+                vector<fs::path> subdirs;
+                vector<SourceFile> found;
+                error_code ec;
+                for (fs::directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec), end; !ec && it != end; it.increment(ec)) {
+                    const fs::directory_entry& de = *it;
+                    error_code fe;
+                    if (de.is_directory(fe)) {
+                        if (!de.is_symlink(fe)) subdirs.push_back(de.path());
+                        continue;
+                    }
+                    if (!de.is_regular_file(fe)) continue;
+                    SourceFile f;
+                    f.source = de.path();
+                    auto rel = de.path().lexically_relative(root).generic_u8string();
+                    f.name.assign(rel.begin(), rel.end());
+                    f.size = (uint64_t)de.file_size(fe);
+                    f.mtime = (int64_t)de.last_write_time(fe).time_since_epoch().count();
+                    found.push_back(move(f));
+                }
+                {
+                    lock_guard<mutex> lk(m);
+                    for (auto& f : found) files.push_back(move(f));
+                    for (auto& d : subdirs) dirs.push_back(move(d));
+                    --busy;
+                }
+                cv.notify_all();
+            }
+        };
+        vector<thread> pool;
+        for (int i = 1; i < max(1, threads); ++i) pool.emplace_back(worker);
+        worker();
+        for (auto& t : pool) t.join();
+        sort(files.begin(), files.end(), [](const SourceFile& a, const SourceFile& b) { return a.name < b.name; });
+        return files;
+    }
+};
+
+// ļȡˮ: ̰߳˳ȡļ (СļΪһ) , һη,
+// ѷ Take(i) ȡ. Ѷδȡֽ budget Լ; СδȡĿβ, ֤ǰ.
+//  maxFileBytes ļȡ, Take ʱ.
+// readers Ϊ 0 ʱ߳, Take ڵֱ߳Ӷȡ: ҳ CPU ֻһʱ, ֻ߳л.
+class FileIngest {
+    struct Slot {
+        vector<uint8_t> data;
+        string error;
+        bool ready = false;
+        bool taken = false;
+    };
+
+    static constexpr size_t BATCH_FILES = 256;
+    static constexpr uint64_t BATCH_BYTES = 4 * 1024 * 1024;
+    static constexpr size_t SPARE_MIN = 64 * 1024;     // СĻֱӷ伴
+
+    const vector<SourceFile>& files;
+    uint64_t budget, maxFileBytes;
+    vector<Slot> slots;
+    mutex m;
+    condition_variable readyCv, roomCv;     // ѷĿ; ̵߳Ԥ
+    size_t nextBatch = 0, lowest = 0;
+    size_t takers = 0, blocked = 0;         // ڵȴѷ / ߳, ˵ȴʱ֪ͨ
+    uint64_t inFlight = 0;
+    bool stopping = false;
+    vector<vector<uint8_t>> spare;          // Take صľɻ, ̸߳, ôļÿ·
+    uint64_t spareBytes = 0;                // spare ,  budget / 2
+    vector<thread> pool;
+
+    static void ReadFile(const SourceFile& f, uint64_t limit, Slot& s) {
+        if (f.size > limit) { s.error = "file too large: " + f.source.string(); return; }
+        ifstream in(f.source, ios::binary);
+        if (!in) { s.error = "cannot open " + f.source.string(); return; }
+        s.data.resize((size_t)f.size);
+        if (f.size && !in.read((char*)s.data.data(), (streamsize)f.size)) s.error = "read failed: " + f.source.string();
+    }
+
+    void Reader() {
+        size_t n = files.size();
+        vector<Slot> batch;
+        for (;;) {
+            size_t b, e;
+            uint64_t bytes = 0;
+            {
+                unique_lock<mutex> lk(m);
+                if (stopping || nextBatch >= n) return;
+                b = e = nextBatch;
+                while (e < n && e - b < BATCH_FILES && (e == b || bytes + files[e].size <= BATCH_BYTES)) bytes += files[e++].size;
+                nextBatch = e;
+                ++blocked;
+                roomCv.wait(lk, [&] { return stopping || inFlight == 0 || inFlight + bytes <= budget || b <= lowest; });
+                --blocked;
+                if (stopping) return;
+                inFlight += bytes;
+                batch.clear();
+                batch.resize(e - b);
+                for (size_t i = b; i < e && !spare.empty(); ++i) {
+                    if (files[i].size < SPARE_MIN) continue;
+                    auto it = find_if(spare.begin(), spare.end(), [&](const vector<uint8_t>& v) { return v.capacity() >= files[i].size; });
+                    if (it == spare.end()) continue;
+                    spareBytes -= it->capacity();
+                    batch[i - b].data.swap(*it);
+                    spare.erase(it);
+                }
+            }
+            for (size_t i = b; i < e; ++i) {
+                Slot& s = batch[i - b];
+                try { ReadFile(files[i], maxFileBytes, s); }
+                catch (const exception& ex) { s.error = ex.what(); }
+                s.ready = true;
+            }
+            bool wake;
+            {
+                lock_guard<mutex> lk(m);
+                for (size_t i = b; i < e; ++i) slots[i] = move(batch[i - b]);
+                wake = takers > 0;
+            }
+            if (wake) readyCv.notify_all();
+        }
+    }
+
+public:
+    FileIngest(const vector<SourceFile>& list, int readers, uint64_t budgetBytes, uint64_t maxFile = UINT64_MAX)
+        : files(list), budget(budgetBytes), maxFileBytes(maxFile), slots(list.size()) {
+        readers = (int)min<size_t>((size_t)max(0, readers), list.size());
+        for (int i = 0; i < readers; ++i) pool.emplace_back([this] { Reader(); });
+    }
+
+    ~FileIngest() { Stop(); }
+
+    FileIngest(const FileIngest&) = delete;
+    FileIngest& operator=(const FileIngest&) = delete;
+
+    // ߳: ж CPU ʱ÷Ҫ; ֻһ CPU ʱ߳ѷͬһ, ֱ Take жȡ
+    static int DefaultReaders(int requested) {
+        return thread::hardware_concurrency() > 1 ? max(1, requested) : 0;
+    }
+
+    // еȴն߳; ֮ Take ׳
+    void Stop() {
+        {
+            lock_guard<mutex> lk(m);
+            stopping = true;
+        }
+        readyCv.notify_all();
+        roomCv.notify_all();
+        for (auto& t : pool) t.join();
+        pool.clear();
+    }
+
+    // ȡߵ i ļ; out ԭеĻ彻ˮ߸
+    void Take(size_t i, vector<uint8_t>& out) {
+        if (pool.empty()) {
+            if (stopping) throw runtime_error("ingest stopped");
+            Slot s;
+            s.data.swap(out);
+            ReadFile(files[i], maxFileBytes, s);
+            if (!s.error.empty()) throw runtime_error(s.error);
+            out.swap(s.data);
+            return;
+        }
+        Slot s;
+        bool wake;
+        {
+            unique_lock<mutex> lk(m);
+            ++takers;
+            readyCv.wait(lk, [&] { return stopping || slots[i].ready; });
+            --takers;
+            if (!slots[i].ready) throw runtime_error("ingest stopped");
+            s = move(slots[i]);
+            slots[i].taken = true;
+            inFlight -= files[i].size;
+            while (lowest < slots.size() && slots[lowest].taken) ++lowest;
+            if (out.capacity() >= SPARE_MIN && spareBytes + out.capacity() <= budget / 2) {
+                spareBytes += out.capacity();
+                spare.push_back(move(out));
+            }
+            wake = blocked > 0;
+        }
+        if (wake) roomCv.notify_all();
+        if (!s.error.empty()) throw runtime_error(s.error);
+        out.swap(s.data);
+    }
+};
+
+// ==========================================
+// ZIP 鵵 (Task A)
+// ==========================================
+// ʽ CRC  slicing-by-8 ʵ
+template<uint32_t Poly>
+struct CrcSlice8 {
+    static uint32_t Update(uint32_t crc, const uint8_t* p, size_t n) {
+        static const auto T = [] {
+            array<array<uint32_t, 256>, 8> t{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? Poly ^ (c >> 1) : c >> 1;
+                t[0][i] = c;
+            }
+            for (int s = 1; s < 8; ++s)
+                for (int i = 0; i < 256; ++i) t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+            return t;
+        }();
+        crc = ~crc;
+        while (n >= 8) {
+            uint32_t lo = ((uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24) ^ crc;
+            uint32_t hi = (uint32_t)p[4] | (uint32_t)p[5] << 8 | (uint32_t)p[6] << 16 | (uint32_t)p[7] << 24;
+            crc = T[7][lo & 0xFF] ^ T[6][(lo >> 8) & 0xFF] ^ T[5][(lo >> 16) & 0xFF] ^ T[4][lo >> 24]
+                ^ T[3][hi & 0xFF] ^ T[2][(hi >> 8) & 0xFF] ^ T[1][(hi >> 16) & 0xFF] ^ T[0][hi >> 24];
+            p += 8; n -= 8;
+        }
+        while (n--) crc = T[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+};
+
+// CRC-32 (ZIP ʹõ IEEE ʽ)
+using Crc32 = CrcSlice8<0xEDB88320u>;
+
+// CRC-32C (Castagnoli, ڱУ):  SSE4.2 ʱ crc32 ָ, 
+struct Crc32c {
+    static uint32_t Update(uint32_t crc, const uint8_t* p, size_t n) {
+#ifdef CRC32C_USE_SSE42
+        uint64_t c = ~crc;
+        for (; n >= 8; p += 8, n -= 8) { uint64_t v; memcpy(&v, p, 8); c = _mm_crc32_u64(c, v); }
+        uint32_t c32 = (uint32_t)c;
+        while (n--) c32 = _mm_crc32_u8(c32, *p++);
+        return ~c32;
+#else
+        return CrcSlice8<0x82F63B78u>::Update(crc, p, n);
+#endif
+    }
+};
+
+// deflate  (RFC 1951): ϣ LZ77 +  Huffman (BTYPE=01), Ϊһտ.
+//  zlib; ѹʵڶ̬ Huffman, ı㹻, ÿļɶѹ.
+class Deflate {
+    static constexpr uint32_t WINDOW = 32768;
+    static constexpr size_t MIN_MATCH = 3, MAX_MATCH = 258;
+    static constexpr int HASH_BITS = 15, MAX_CHAIN = 64;
+
+    struct Tables {
+        uint16_t litCode[288]; uint8_t litLen[288];
+        uint8_t lenSym[MAX_MATCH + 1];
+        uint16_t lenBase[29]; uint8_t lenExtra[29];
+        uint16_t distBase[30]; uint8_t distExtra[30]; uint8_t distCode[30];
+    };
+
+    static uint32_t Reverse(uint32_t code, int len) {
+        uint32_t r = 0;
+        for (int i = 0; i < len; ++i) { r = (r << 1) | (code & 1); code >>= 1; }
+        return r;
+    }
+
+    static const Tables& T() {
+        static const Tables t = [] {
+            Tables t{};
+            for (int v = 0; v < 288; ++v) {
+                uint32_t code; int len;
+                if (v < 144) { code = 0x30 + v; len = 8; }
+                else if (v < 256) { code = 0x190 + (v - 144); len = 9; }
+                else if (v < 280) { code = v - 256; len = 7; }
+                else { code = 0xC0 + (v - 280); len = 8; }
+                t.litCode[v] = (uint16_t)Reverse(code, len); t.litLen[v] = (uint8_t)len;
+            }
+            static const uint16_t lb[29] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+            static const uint8_t le[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+            static const uint16_t db[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+            static const uint8_t de[30] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+            for (int s = 0; s < 29; ++s) {
+                t.lenBase[s] = lb[s]; t.lenExtra[s] = le[s];
+                for (int l = lb[s]; l < lb[s] + (1 << le[s]) && l <= (int)MAX_MATCH; ++l) t.lenSym[l] = (uint8_t)s;
+            }
+            t.lenSym[MAX_MATCH] = 28;
+            for (int s = 0; s < 30; ++s) { t.distBase[s] = db[s]; t.distExtra[s] = de[s]; t.distCode[s] = (uint8_t)Reverse(s, 5); }
+            return t;
+        }();
+        return t;
+    }
+
+    vector<uint8_t>& out;
+    uint64_t bits = 0;
+    int nbits = 0;
+
+    explicit Deflate(vector<uint8_t>& o) : out(o) {}
+
+    void Put(uint32_t v, int n) {
+        bits |= (uint64_t)v << nbits; nbits += n;
+        while (nbits >= 8) { out.push_back((uint8_t)bits); bits >>= 8; nbits -= 8; }
+    }
+    void Symbol(int v) { Put(T().litCode[v], T().litLen[v]); }
+    void Match(size_t len, uint32_t dist) {
+        const Tables& t = T();
+        int ls = t.lenSym[len];
+        Symbol(257 + ls);
+        if (t.lenExtra[ls]) Put((uint32_t)(len - t.lenBase[ls]), t.lenExtra[ls]);
+        int ds = (int)(upper_bound(t.distBase, t.distBase + 30, dist) - t.distBase) - 1;
+        Put(t.distCode[ds], 5);
+        if (t.distExtra[ds]) Put(dist - t.distBase[ds], t.distExtra[ds]);
+    }
+
+public:
+    static void Compress(const uint8_t* p, size_t n, vector<uint8_t>& out) {
+        out.clear();
+        out.reserve(n / 2 + 64);
+        Deflate d(out);
+        // head / prev λ + 1, 0 ʾ
+        vector<uint32_t> head((size_t)1 << HASH_BITS, 0), prev(WINDOW, 0);
+        auto hash = [&](size_t k) {
+            uint32_t v = (uint32_t)p[k] | (uint32_t)p[k + 1] << 8 | (uint32_t)p[k + 2] << 16;
+            return (v * 2654435761u) >> (32 - HASH_BITS);
+        };
+        auto insert = [&](size_t k) {
+            uint32_t h = hash(k);
+            prev[k & (WINDOW - 1)] = head[h];
+            head[h] = (uint32_t)k + 1;
+        };
+
+        d.Put(1, 1); d.Put(1, 2);   // BFINAL=1, BTYPE=01
+        size_t i = 0;
+        while (i < n) {
+            size_t bestLen = 0; uint32_t bestDist = 0;
+            if (i + MIN_MATCH <= n) {
+                size_t maxLen = min(MAX_MATCH, n - i);
+                uint32_t cand = head[hash(i)];
+                for (int chain = MAX_CHAIN; cand && chain > 0; --chain) {
+                    size_t c = cand - 1;
+                    if (i - c > WINDOW) break;
+                    if (p[c + bestLen] == p[i + bestLen]) {
+                        size_t L = 0;
+                        while (L < maxLen && p[c + L] == p[i + L]) ++L;
+                        if (L > bestLen) {
+                            bestLen = L; bestDist = (uint32_t)(i - c);
+                            if (L == maxLen) break;
+                        }
+                    }
+                    cand = prev[c & (WINDOW - 1)];
+                }
+                insert(i);
+            }
+            if (bestLen >= MIN_MATCH) {
+                d.Match(bestLen, bestDist);
+                for (size_t k = i + 1; k < i + bestLen && k + MIN_MATCH <= n; ++k) insert(k);
+                i += bestLen;
+            }
+            else {
+                d.Symbol(p[i]);
+                ++i;
+            }
+        }
+        d.Symbol(256);
+        if (d.nbits) out.push_back((uint8_t)d.bits);
+    }
+};
+
+enum class ZipMethod { Store, Deflate };
+
+struct ZipResult {
+    size_t files = 0;
+    uint64_t rawBytes = 0;
+    uint64_t zipBytes = 0;
+    double seconds = 0;
+    double MBps() const { return seconds > 0 ? (double)rawBytes / (1024.0 * 1024.0) / seconds : 0; }
+};
+
+// ʽ ZIP д: FileIngest ļ, ̰߳Ŀ˳ȡѹ, ̰߳˳ɵĿд鵵.
+// Ѷδѹֽ;Ŀ () , дͷѹ. д .part ļ, ɹٸ.
+// ֧ ZIP64: ļ鵵 4 GBĿ 65535 ʱ.
+class ZipWriter {
+    struct Packed {
+        vector<uint8_t> data;
+        uint32_t crc = 0;
+        uint64_t rawSize = 0;
+        uint16_t method = 0, dosTime = 0, dosDate = 0;
+        bool ready = false;
+        string error;
+    };
+
+    static void Put16(vector<uint8_t>& b, uint16_t v) { b.push_back((uint8_t)v); b.push_back((uint8_t)(v >> 8)); }
+    static void Put32(vector<uint8_t>& b, uint32_t v) { Put16(b, (uint16_t)v); Put16(b, (uint16_t)(v >> 16)); }
+
+    static constexpr uint64_t INGEST_BUDGET = 64 * 1024 * 1024;
+
+    static void DosTime(int64_t mtime, uint16_t& time, uint16_t& date) {
+        fs::file_time_type ft{ fs::file_time_type::duration(mtime) };
+        auto sys = chrono::time_point_cast<chrono::system_clock::duration>(ft - fs::file_time_type::clock::now() + chrono::system_clock::now());
+        time_t tt = chrono::system_clock::to_time_t(sys);
+        struct tm t; localtime_s(&t, &tt);
+        if (t.tm_year < 80) { time = 0; date = (1 << 5) | 1; return; }
+        time = (uint16_t)((t.tm_hour << 11) | (t.tm_min << 5) | (t.tm_sec / 2));
+        date = (uint16_t)(((t.tm_year - 80) << 9) | ((t.tm_mon + 1) << 5) | t.tm_mday);
+    }
+
+    static void Pack(const SourceFile& e, vector<uint8_t>& raw, ZipMethod method, Packed& out) {
+        out.rawSize = raw.size();
+        out.crc = Crc32::Update(0, raw.data(), raw.size());
+        DosTime(e.mtime, out.dosTime, out.dosDate);
+        if (method == ZipMethod::Deflate && !raw.empty()) {
+            Deflate::Compress(raw.data(), raw.size(), out.data);
+            if (out.data.size() < raw.size()) { out.method = 8; return; }
+        }
+        out.method = 0;
+        out.data.swap(raw);
+    }
+
+public:
+    static ZipResult Write(const fs::path& dest, const vector<SourceFile>& entries, ZipMethod method, int threads) {
+        if (entries.size() >= 0xFFFF) throw runtime_error("too many entries for ZIP32");
+        auto t0 = chrono::steady_clock::now();
+        size_t n = entries.size();
+        threads = (int)max<size_t>(1, min<size_t>((size_t)max(1, threads), n));
+        const size_t window = (size_t)threads * 2;
+
+        vector<Packed> slots(n);
+        mutex m;
+        condition_variable cv;
+        size_t next = 0, written = 0;
+        bool abort = false;
+        FileIngest ingest(entries, FileIngest::DefaultReaders(threads), INGEST_BUDGET, 0xFFFFFFFEull);
+
+        auto worker = [&] {
+            for (;;) {
+                size_t k;
+                {
+                    unique_lock<mutex> lk(m);
+                    cv.wait(lk, [&] { return abort || next >= n || next < written + window; });
+                    if (abort || next >= n) return;
+                    k = next++;
+                }
+                Packed p;
+                try {
+                    vector<uint8_t> raw;
+                    ingest.Take(k, raw);
+                    Pack(entries[k], raw, method, p);
+                }
+                catch (const exception& e) { p.error = e.what(); }
+                {
+                    lock_guard<mutex> lk(m);
+                    p.ready = true;
+                    slots[k] = move(p);
+                }
+                cv.notify_all();
+            }
+        };
+        vector<thread> pool;
+        for (int i = 0; i < threads; ++i) pool.emplace_back(worker);
+        auto stop = [&] {
+            { lock_guard<mutex> lk(m); abort = true; }
+            cv.notify_all();
+            ingest.Stop();
+            for (auto& t : pool) t.join();
+            pool.clear();
+        };
+
+        fs::path part = dest;
+        part += ".part";
+        ZipResult res;
+        try {
+            ofstream out(part, ios::binary | ios::trunc);
+            if (!out) throw runtime_error("cannot create " + part.string());
+
+            vector<uint8_t> central, hdr;
+            uint64_t offset = 0;
+            for (size_t i = 0; i < n; ++i) {
+                Packed p;
+                {
+                    unique_lock<mutex> lk(m);
+                    cv.wait(lk, [&] { return slots[i].ready; });
+                    p = move(slots[i]);
+                    ++written;
+                }
+                cv.notify_all();
+                if (!p.error.empty()) throw runtime_error(p.error);
+
+                const string& name = entries[i].name;
+                if (offset + 30 + name.size() + p.data.size() >= 0xFFFFFFFFull) throw runtime_error("archive exceeds 4 GB");
+                hdr.clear();
+                Put32(hdr, 0x04034b50); Put16(hdr, 20); Put16(hdr, 0x0800); Put16(hdr, p.method);
+                Put16(hdr, p.dosTime); Put16(hdr, p.dosDate); Put32(hdr, p.crc);
+                Put32(hdr, (uint32_t)p.data.size()); Put32(hdr, (uint32_t)p.rawSize);
+                Put16(hdr, (uint16_t)name.size()); Put16(hdr, 0);
+                hdr.insert(hdr.end(), name.begin(), name.end());
+                out.write((const char*)hdr.data(), (streamsize)hdr.size());
+                out.write((const char*)p.data.data(), (streamsize)p.data.size());
+                if (!out) throw runtime_error("write failed: " + part.string());
+
+                Put32(central, 0x02014b50); Put16(central, 20); Put16(central, 20); Put16(central, 0x0800); Put16(central, p.method);
+                Put16(central, p.dosTime); Put16(central, p.dosDate); Put32(central, p.crc);
+                Put32(central, (uint32_t)p.data.size()); Put32(central, (uint32_t)p.rawSize);
+                Put16(central, (uint16_t)name.size()); Put16(central, 0); Put16(central, 0);
+                Put16(central, 0); Put16(central, 0); Put32(central, 0); Put32(central, (uint32_t)offset);
+                central.insert(central.end(), name.begin(), name.end());
+
+                offset += hdr.size() + p.data.size();
+                res.rawBytes += p.rawSize;
+                ++res.files;
+            }
+
+            if (offset + central.size() >= 0xFFFFFFFFull) throw runtime_error("archive exceeds 4 GB");
+            Put32(central, 0x06054b50); Put16(central, 0); Put16(central, 0);
+            Put16(central, (uint16_t)n); Put16(central, (uint16_t)n);
+            Put32(central, (uint32_t)(central.size() - 12)); Put32(central, (uint32_t)offset); Put16(central, 0);
+            out.write((const char*)central.data(), (streamsize)central.size());
+            out.close();
+            if (!out) throw runtime_error("write failed: " + part.string());
+            res.zipBytes = offset + central.size();
+        }
+        catch (...) {
+            stop();
+            error_code ec;
+            fs::remove(part, ec);
+            throw;
+        }
+        stop();
+        fs::rename(part, dest);
+        res.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        return res;
+    }
+};
+
+// ==========================================
+// ȥر (Task A)
+// ==========================================
+// XXH64 (μ)
+struct Xxh64 {
+    static constexpr uint64_t P1 = 11400714785074694791ull, P2 = 14029467366897019727ull,
+        P3 = 1609587929392839161ull, P4 = 9650029242287828579ull, P5 = 2870177450012600261ull;
+
+    static uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+    static uint64_t Read64(const uint8_t* p) { uint64_t v; memcpy(&v, p, 8); return v; }
+    static uint32_t Read32(const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+    static uint64_t Round(uint64_t acc, uint64_t in) { return Rotl(acc + in * P2, 31) * P1; }
+    static uint64_t Merge(uint64_t acc, uint64_t v) { return (acc ^ Round(0, v)) * P1 + P4; }
+
+    static uint64_t Hash(const void* data, size_t len, uint64_t seed = 0) {
+        const uint8_t* p = (const uint8_t*)data;
+        const uint8_t* end = p + len;
+        uint64_t h;
+        if (len >= 32) {
+            uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+            for (; p + 32 <= end; p += 32) {
+                v1 = Round(v1, Read64(p)); v2 = Round(v2, Read64(p + 8));
+                v3 = Round(v3, Read64(p + 16)); v4 = Round(v4, Read64(p + 24));
+            }
+            h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+            h = Merge(h, v1); h = Merge(h, v2); h = Merge(h, v3); h = Merge(h, v4);
+        }
+        else {
+            h = seed + P5;
+        }
+        h += (uint64_t)len;
+        for (; p + 8 <= end; p += 8) h = Rotl(h ^ Round(0, Read64(p)), 27) * P1 + P4;
+        if (p + 4 <= end) { h = Rotl(h ^ ((uint64_t)Read32(p) * P1), 23) * P2 + P3; p += 4; }
+        for (; p < end; ++p) h = Rotl(h ^ (*p * P5), 11) * P1;
+        h ^= h >> 33; h *= P2; h ^= h >> 29; h *= P3; h ^= h >> 32;
+        return h;
+    }
+};
+
+// ʶ: ӵ XXH64  128 λժҪ, ӿ鳤
+struct ChunkId {
+    uint64_t h[2] = { 0, 0 };
+    uint32_t size = 0;
+
+    static ChunkId Of(const uint8_t* p, size_t n) {
+        ChunkId id;
+        id.h[0] = Xxh64::Hash(p, n, 0);
+        id.h[1] = Xxh64::Hash(p, n, Xxh64::P1);
+        id.size = (uint32_t)n;
+        return id;
+    }
+
+    string Hex() const {
+        char s[33];
+        static const char* digits = "0123456789abcdef";
+        for (int i = 0; i < 32; ++i) s[i] = digits[(h[i / 16] >> (60 - 4 * (i % 16))) & 0xF];
+        return string(s, 32);
+    }
+
+    static bool Parse(string_view hex, uint32_t size, ChunkId& out) {
+        if (hex.size() != 32) return false;
+        for (int k = 0; k < 2; ++k) {
+            auto r = from_chars(hex.data() + 16 * k, hex.data() + 16 * (k + 1), out.h[k], 16);
+            if (r.ec != errc() || r.ptr != hex.data() + 16 * (k + 1)) return false;
+        }
+        out.size = size;
+        return true;
+    }
+
+    bool operator==(const ChunkId& o) const { return h[0] == o.h[0] && h[1] == o.h[1] && size == o.size; }
+};
+
+struct ChunkIdHash {
+    size_t operator()(const ChunkId& c) const { return (size_t)c.h[0]; }
+};
+
+// ݶֿ: Gear ϣ + FastCDC ʽһ (ƽǰýϵ, ֮ýɵ).
+// еֻȡǰ, ļмֻӰ츽Ŀ.
+class GearChunker {
+    static constexpr uint64_t MASK_S = ~0ull << (64 - 18);
+    static constexpr uint64_t MASK_L = ~0ull << (64 - 14);
+
+    static const uint64_t* Gear() {
+        static const auto g = [] {
+            array<uint64_t, 256> t{};
+            uint64_t x = 0x6A09E667F3BCC909ull;
+            for (auto& v : t) {
+                uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                v = z ^ (z >> 31);
+            }
+            return t;
+        }();
+        return g.data();
+    }
+
+public:
+    static constexpr size_t MIN_SIZE = 16 * 1024, AVG_SIZE = 64 * 1024, MAX_SIZE = 256 * 1024;
+
+    // صһĳ. ÷豣֤ n >= MAX_SIZE  p[0..n) ļʣȫ.
+    static size_t Cut(const uint8_t* p, size_t n) {
+        if (n <= MIN_SIZE) return n;
+        const uint64_t* G = Gear();
+        uint64_t h = 0;
+        size_t i = MIN_SIZE;
+        size_t normal = min(n, AVG_SIZE), end = min(n, MAX_SIZE);
+        for (; i < normal; ++i) { h = (h << 1) + G[p[i]]; if (!(h & MASK_S)) return i + 1; }
+        for (; i < end; ++i) { h = (h << 1) + G[p[i]]; if (!(h & MASK_L)) return i + 1; }
+        return end;
+    }
+};
+
+struct BackupFile {
+    string name;            // ·, '/' ָ
+    uint64_t size = 0;
+    int64_t mtime = 0;      // file_time_type ļ
+    uint64_t hash = 0;      // ʶе XXH64
+    vector<ChunkId> chunks;
+};
+
+struct BackupResult {
+    string snapshot;
+    size_t files = 0, changedFiles = 0, newChunks = 0;
+    uint64_t totalBytes = 0;    // ոǵ
+    uint64_t scannedBytes = 0;  // ʵʶȡ
+    uint64_t storedBytes = 0;   // д洢
+    double seconds = 0;
+    vector<BackupFile> changed; // ·ֿļ; ¿ֻЩļ, Уֻ
+};
+
+// 洢 + 嵥:
+//   root/chunks/ab/<32 λʮ>   ÿһļ, ƼժҪ, ֻдһ
+//   root/snapshots/<name>.snap       ı嵥, ÿļһ "F size mtime hash nchunks name" Ӹ "id size"
+// ¿Ϊ׼: С޸ʱ䶼δļֱþɼ¼, ;
+// ļзֿ, ֻд洢вڵĿ.
+class BackupStore {
+    fs::path root;
+    mutex storeMutex;
+    unordered_set<ChunkId, ChunkIdHash> seen;     // ȷϴڵĿ
+
+    static constexpr size_t READ_BLOCK = 4 * 1024 * 1024;
+
+    fs::path SnapshotPath(const string& name) const { return root / "snapshots" / (name + ".snap"); }
+
+    static uint64_t FileHash(const vector<ChunkId>& chunks) {
+        vector<uint64_t> words;
+        words.reserve(chunks.size() * 3);
+        for (auto& c : chunks) { words.push_back(c.h[0]); words.push_back(c.h[1]); words.push_back(c.size); }
+        return Xxh64::Hash(words.data(), words.size() * sizeof(uint64_t), 0);
+    }
+
+    // дһ; Ѵ򷵻 false
+    bool StoreChunk(const ChunkId& id, const uint8_t* p) {
+        {
+            lock_guard<mutex> lk(storeMutex);
+            if (!seen.insert(id).second) return false;
+        }
+        fs::path path = ChunkPath(id);
+        error_code ec;
+        if (fs::exists(path, ec)) return false;
+        fs::create_directories(path.parent_path(), ec);
+        fs::path tmp = path;
+        tmp += ".tmp";
+        {
+            ofstream out(tmp, ios::binary | ios::trunc);
+            out.write((const char*)p, id.size);
+            out.close();
+            if (!out) throw runtime_error("chunk write failed: " + tmp.string());
+        }
+        fs::rename(tmp, path);
+        return true;
+    }
+
+    void ChunkFile(const fs::path& src, BackupFile& rec, BackupResult& res) {
+        ifstream in(src, ios::binary);
+        if (!in) throw runtime_error("cannot open " + src.string());
+        vector<uint8_t> buf(READ_BLOCK + GearChunker::MAX_SIZE);
+        size_t have = 0;
+        bool eof = false;
+        uint64_t scanned = 0, stored = 0;
+        size_t fresh = 0;
+        rec.chunks.clear();
+        while (!eof || have > 0) {
+            if (!eof && have < GearChunker::MAX_SIZE) {
+                in.read((char*)buf.data() + have, (streamsize)(buf.size() - have));
+                size_t got = (size_t)in.gcount();
+                if (got == 0 || !in) eof = true;
+                if (in.bad()) throw runtime_error("read failed: " + src.string());
+                have += got;
+                scanned += got;
+                continue;
+            }
+            size_t off = 0;
+            while (have - off >= GearChunker::MAX_SIZE || (eof && off < have)) {
+                size_t len = GearChunker::Cut(buf.data() + off, have - off);
+                ChunkId id = ChunkId::Of(buf.data() + off, len);
+                if (StoreChunk(id, buf.data() + off)) { ++fresh; stored += len; }
+                rec.chunks.push_back(id);
+                off += len;
+            }
+            memmove(buf.data(), buf.data() + off, have - off);
+            have -= off;
+        }
+        rec.size = scanned;
+        rec.hash = FileHash(rec.chunks);
+        lock_guard<mutex> lk(storeMutex);
+        res.scannedBytes += scanned;
+        res.storedBytes += stored;
+        res.newChunks += fresh;
+    }
+
+    void WriteSnapshot(const string& name, const vector<BackupFile>& files) const {
+        fs::path path = SnapshotPath(name), tmp = path;
+        tmp += ".part";
+        fs::create_directories(path.parent_path());
+        {
+            ofstream out(tmp, ios::binary | ios::trunc);
+            out << "# snapshot v1\n";
+            for (auto& f : files) {
+                out << "F " << f.size << ' ' << f.mtime << ' ' << hex << f.hash << dec << ' ' << f.chunks.size() << ' ' << f.name << '\n';
+                for (auto& c : f.chunks) out << c.Hex() << ' ' << c.size << '\n';
+            }
+            out.close();
+            if (!out) throw runtime_error("snapshot write failed: " + tmp.string());
+        }
+        fs::rename(tmp, path);
+    }
+
+public:
+    explicit BackupStore(fs::path dir) : root(move(dir)) {}
+
+    fs::path ChunkPath(const ChunkId& id) const {
+        string h = id.Hex();
+        return root / "chunks" / h.substr(0, 2) / h;
+    }
+
+    //  (ʱ) Ŀб
+    vector<string> Snapshots() const {
+        vector<string> names;
+        error_code ec;
+        for (auto& de : fs::directory_iterator(root / "snapshots", ec))
+            if (de.path().extension() == ".snap") names.push_back(de.path().stem().string());
+        sort(names.begin(), names.end());
+        return names;
+    }
+
+    vector<BackupFile> Load(const string& name) const {
+        ifstream in(SnapshotPath(name), ios::binary);
+        if (!in) throw runtime_error("snapshot not found: " + name);
+        vector<BackupFile> files;
+        string line;
+        while (getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            BackupFile f;
+            size_t n = 0;
+            istringstream ls(line.substr(2));
+            ls >> f.size >> f.mtime >> hex >> f.hash >> dec >> n;
+            ls.get();
+            getline(ls, f.name);
+            if (line[0] != 'F' || !ls) throw runtime_error("corrupt snapshot: " + name);
+            f.chunks.resize(n);
+            for (auto& c : f.chunks) {
+                string id; uint32_t sz = 0;
+                if (!getline(in, line)) throw runtime_error("truncated snapshot: " + name);
+                istringstream cs(line);
+                cs >> id >> sz;
+                if (!ChunkId::Parse(id, sz, c)) throw runtime_error("corrupt snapshot: " + name);
+            }
+            files.push_back(move(f));
+        }
+        return files;
+    }
+
+    BackupResult Backup(const fs::path& src, const string& name, int threads) {
+        auto t0 = chrono::steady_clock::now();
+        unordered_map<string, const BackupFile*> prevByName;
+        vector<BackupFile> prev;
+        auto snaps = Snapshots();
+        if (!snaps.empty()) {
+            prev = Load(snaps.back());
+            for (auto& f : prev) prevByName[f.name] = &f;
+        }
+
+        auto entries = SourceScanner::Walk(src, threads);
+        vector<BackupFile> files(entries.size());
+        vector<size_t> changed;
+        BackupResult res;
+        res.snapshot = name;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            BackupFile& f = files[i];
+            f.name = entries[i].name;
+            f.size = entries[i].size;
+            f.mtime = entries[i].mtime;
+            auto it = prevByName.find(f.name);
+            if (it != prevByName.end() && it->second->size == f.size && it->second->mtime == f.mtime) f = *it->second;
+            else changed.push_back(i);
+        }
+
+        ParallelFor(changed.size(), threads, [&](size_t k) {
+            size_t i = changed[k];
+            ChunkFile(entries[i].source, files[i], res);
+        });
+
+        WriteSnapshot(name, files);
+        res.files = files.size();
+        res.changedFiles = changed.size();
+        res.changed.reserve(changed.size());
+        for (size_t i : changed) res.changed.push_back(files[i]);
+        for (auto& f : files) res.totalBytes += f.size;
+        res.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        return res;
+    }
+
+    // ѿջԭ target, У鳤ժҪ, ָ޸ʱ
+    BackupResult Restore(const string& name, const fs::path& target, int threads) const {
+        auto t0 = chrono::steady_clock::now();
+        vector<BackupFile> files = Load(name);
+        BackupResult res;
+        res.snapshot = name;
+        mutex m;
+        ParallelFor(files.size(), threads, [&](size_t i) {
+            const BackupFile& f = files[i];
+            fs::path out = target / fs::path(u8string(f.name.begin(), f.name.end()));
+            fs::create_directories(out.parent_path());
+            ofstream os(out, ios::binary | ios::trunc);
+            if (!os) throw runtime_error("cannot create " + out.string());
+            vector<uint8_t> buf;
+            for (auto& c : f.chunks) {
+                buf.resize(c.size);
+                ifstream is(ChunkPath(c), ios::binary);
+                if (!is.read((char*)buf.data(), c.size) || is.peek() != EOF || !(ChunkId::Of(buf.data(), buf.size()) == c))
+                    throw runtime_error("chunk missing or corrupt: " + c.Hex());
+                os.write((const char*)buf.data(), c.size);
+            }
+            os.close();
+            if (!os) throw runtime_error("write failed: " + out.string());
+            if (FileHash(f.chunks) != f.hash) throw runtime_error("manifest hash mismatch: " + f.name);
+            fs::last_write_time(out, fs::file_time_type(fs::file_time_type::duration(f.mtime)));
+            lock_guard<mutex> lk(m);
+            res.totalBytes += f.size;
+        });
+        res.files = files.size();
+        res.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        return res;
+    }
+};
+
+// ==========================================
+// У (Task A)
+// ==========================================
+// inflate  (RFC 1951): ִ֧洢顢붯̬ Huffman .
+// Huffman  15 λֱӲ ( =  << 4 | 볤), ÿһβ.
+// : ѹÿζ IN_BLOCK,  OUT_BLOCK ͽ sink,
+// out ֻ 32 KB ؿ, ڴļС޹.
+class Inflate {
+    istream& src;
+    uint64_t srcLeft;           // δ inBuf ѹֽ
+    vector<uint8_t> inBuf;
+    size_t inLen = 0, pos = 0, padded = 0;     // padded: ľ󲹵ֽ
+    uint64_t bitBuf = 0;
+    int bitCnt = 0;
+    vector<uint8_t> out;
+    const function<void(const uint8_t*, size_t)>& sink;
+    vector<uint16_t> litTable, distTable;
+
+    static constexpr int TABLE_BITS = 15;
+    static constexpr size_t WINDOW = 32768, IN_BLOCK = 256 * 1024, OUT_BLOCK = 256 * 1024;
+
+    void Refill() {
+        while (bitCnt <= 56) {
+            if (pos == inLen && srcLeft) {
+                inLen = (size_t)min<uint64_t>(srcLeft, inBuf.size());
+                if (!src.read((char*)inBuf.data(), (streamsize)inLen)) throw runtime_error("inflate: truncated input");
+                srcLeft -= inLen; pos = 0;
+            }
+            uint64_t b = 0;
+            if (pos < inLen) b = inBuf[pos++];
+            else ++padded;      // Խ粹,  Consume 
+            bitBuf |= b << bitCnt;
+            bitCnt += 8;
+        }
+    }
+    void Consume(int n) {
+        bitBuf >>= n; bitCnt -= n;
+        if (padded * 8 > (size_t)bitCnt) throw runtime_error("inflate: truncated input");
+    }
+
+    //  out[emitted..] , ֻ WINDOW ֽڹؿ
+    size_t emitted = 0;
+    void Drain() {
+        sink(out.data() + emitted, out.size() - emitted);
+        if (out.size() > WINDOW) {
+            memmove(out.data(), out.data() + out.size() - WINDOW, WINDOW);
+            out.resize(WINDOW);
+        }
+        emitted = out.size();
+    }
+    uint32_t Bits(int n) {
+        if (n == 0) return 0;
+        if (bitCnt < n) Refill();
+        uint32_t v = (uint32_t)(bitBuf & ((1ull << n) - 1));
+        Consume(n);
+        return v;
+    }
+
+    static void Build(vector<uint16_t>& table, const uint8_t* lengths, int n) {
+        uint16_t count[16] = {}, next[16] = {};
+        for (int i = 0; i < n; ++i) ++count[lengths[i]];
+        count[0] = 0;
+        int left = 1;
+        for (int len = 1; len < 16; ++len) {
+            left = (left << 1) - count[len];
+            if (left < 0) throw runtime_error("inflate: over-subscribed code");
+        }
+        for (int len = 1, code = 0; len < 16; ++len) { code = (code + count[len - 1]) << 1; next[len] = (uint16_t)code; }
+        table.assign((size_t)1 << TABLE_BITS, 0);
+        for (int s = 0; s < n; ++s) {
+            int len = lengths[s];
+            if (!len) continue;
+            uint32_t code = next[len]++, rev = 0;
+            for (int i = 0; i < len; ++i) { rev = (rev << 1) | (code & 1); code >>= 1; }
+            for (uint32_t k = rev; k < (1u << TABLE_BITS); k += 1u << len) table[k] = (uint16_t)(s << 4 | len);
+        }
+    }
+
+    int Decode(const vector<uint16_t>& table) {
+        if (bitCnt < TABLE_BITS) Refill();
+        uint16_t e = table[bitBuf & ((1u << TABLE_BITS) - 1)];
+        if (!(e & 0xF)) throw runtime_error("inflate: invalid code");
+        Consume(e & 0xF);
+        return e >> 4;
+    }
+
+    void Codes() {
+        static const uint16_t lb[29] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+        static const uint8_t le[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+        static const uint16_t db[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+        static const uint8_t de[30] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+        for (;;) {
+            if (out.size() >= WINDOW + OUT_BLOCK) Drain();
+            int sym = Decode(litTable);
+            if (sym < 256) { out.push_back((uint8_t)sym); continue; }
+            if (sym == 256) return;
+            sym -= 257;
+            if (sym >= 29) throw runtime_error("inflate: bad length symbol");
+            size_t len = lb[sym] + Bits(le[sym]);
+            int ds = Decode(distTable);
+            if (ds >= 30) throw runtime_error("inflate: bad distance symbol");
+            size_t dist = db[ds] + Bits(de[ds]);
+            if (dist > out.size()) throw runtime_error("inflate: distance too far back");
+            size_t from = out.size() - dist;
+            for (size_t i = 0; i < len; ++i) out.push_back(out[from + i]);
+        }
+    }
+
+    void Stored() {
+        Bits(bitCnt & 7);   // 뵽ֽڱ߽
+        uint32_t len = Bits(16), nlen = Bits(16);
+        if ((len ^ 0xFFFF) != nlen) throw runtime_error("inflate: stored length mismatch");
+        for (uint32_t i = 0; i < len; ++i) out.push_back((uint8_t)Bits(8));
+    }
+
+    void Fixed() {
+        uint8_t lengths[288 + 30];
+        for (int s = 0; s < 288; ++s) lengths[s] = s < 144 ? 8 : s < 256 ? 9 : s < 280 ? 7 : 8;
+        for (int s = 0; s < 30; ++s) lengths[288 + s] = 5;
+        Build(litTable, lengths, 288);
+        Build(distTable, lengths + 288, 30);
+        Codes();
+    }
+
+    void Dynamic() {
+        static const uint8_t order[19] = { 16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15 };
+        int nlen = (int)Bits(5) + 257, ndist = (int)Bits(5) + 1, ncode = (int)Bits(4) + 4;
+        if (nlen > 286 || ndist > 30) throw runtime_error("inflate: bad code counts");
+        uint8_t lengths[286 + 30] = {};
+        for (int i = 0; i < ncode; ++i) lengths[order[i]] = (uint8_t)Bits(3);
+        Build(litTable, lengths, 19);
+        memset(lengths, 0, sizeof(lengths));
+        for (int i = 0; i < nlen + ndist;) {
+            int sym = Decode(litTable);
+            if (sym < 16) { lengths[i++] = (uint8_t)sym; continue; }
+            int rep, val = 0;
+            if (sym == 16) {
+                if (i == 0) throw runtime_error("inflate: repeat with no first length");
+                val = lengths[i - 1]; rep = 3 + (int)Bits(2);
+            }
+            else if (sym == 17) rep = 3 + (int)Bits(3);
+            else rep = 11 + (int)Bits(7);
+            if (i + rep > nlen + ndist) throw runtime_error("inflate: too many lengths");
+            while (rep--) lengths[i++] = (uint8_t)val;
+        }
+        if (!lengths[256]) throw runtime_error("inflate: missing end-of-block code");
+        Build(litTable, lengths, nlen);
+        Build(distTable, lengths + nlen, ndist);
+        Codes();
+    }
+
+    Inflate(istream& in, uint64_t n, const function<void(const uint8_t*, size_t)>& f)
+        : src(in), srcLeft(n), inBuf((size_t)min<uint64_t>(n, IN_BLOCK)), sink(f) {
+        out.reserve(WINDOW + OUT_BLOCK + 65536);
+    }
+
+public:
+    //  in ĵǰλýѹ n ֽڵ deflate , ݰ齻 sink
+    static void Decompress(istream& in, uint64_t n, const function<void(const uint8_t*, size_t)>& sink) {
+        Inflate d(in, n, sink);
+        for (bool last = false; !last;) {
+            last = d.Bits(1) != 0;
+            switch (d.Bits(2)) {
+            case 0: d.Stored(); break;
+            case 1: d.Fixed(); break;
+            case 2: d.Dynamic(); break;
+            default: throw runtime_error("inflate: invalid block type");
+            }
+            if (d.out.size() >= WINDOW + OUT_BLOCK) d.Drain();
+        }
+        d.Drain();
+    }
+};
+
+// ģʽʽȡ, ô洢 CRC-32 ˶Թ鵵.
+// Checksum: ߶ԴļУ, 鵵д CRC-32 /  id Ƚ, ض鵵;
+// Compare: ߽鵵ݱԴļȽ.
+enum class VerifyMode { None, Checksum, Compare };
+
+struct VerifyResult {
+    size_t files = 0, mismatches = 0;
+    uint64_t bytes = 0;         // Դ鵵ϼƶȡ/Уֽ
+    double seconds = 0;
+    string firstError;
+    double MBps() const { return seconds > 0 ? (double)bytes / (1024.0 * 1024.0) / seconds : 0; }
+};
+
+// ļУ鱸: ZIP 鵵ȥؿ. һµļ mismatches, жļ.
+class BackupVerifier {
+    static constexpr size_t BLOCK = 256 * 1024;
+
+    //  in ĵǰλð n ֽ, 齻 f
+    template<class F> static void ReadBlocks(istream& in, uint64_t n, F f) {
+        vector<uint8_t> buf((size_t)min<uint64_t>(n, BLOCK));
+        while (n > 0) {
+            size_t k = (size_t)min<uint64_t>(n, buf.size());
+            if (!in.read((char*)buf.data(), (streamsize)k)) throw runtime_error("unexpected end of file");
+            f(buf.data(), k);
+            n -= k;
+        }
+    }
+
+    static uint16_t Get16(const uint8_t* p) { return (uint16_t)(p[0] | p[1] << 8); }
+    static uint32_t Get32(const uint8_t* p) { return (uint32_t)Get16(p) | (uint32_t)Get16(p + 2) << 16; }
+
+    template<class F> static VerifyResult Run(size_t n, int threads, F check) {
+        auto t0 = chrono::steady_clock::now();
+        VerifyResult res;
+        mutex m;
+        ParallelFor(n, threads, [&](size_t i) {
+            uint64_t bytes = 0;
+            string err;
+            try { err = check(i, bytes); }
+            catch (const exception& e) { err = e.what(); }
+            lock_guard<mutex> lk(m);
+            res.bytes += bytes;
+            if (!err.empty() && res.mismatches++ == 0) res.firstError = err;
+        });
+        res.files = n;
+        res.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        return res;
+    }
+
+public:
+    static VerifyResult VerifyZip(const fs::path& zip, const fs::path& srcRoot, VerifyMode mode, int threads) {
+        struct Entry { string name; uint16_t method; uint32_t crc, csize, usize, offset; };
+        vector<Entry> entries;
+        {
+            vector<uint8_t> tail;
+            ifstream in(zip, ios::binary);
+            if (!in) throw runtime_error("cannot open " + zip.string());
+            uint64_t size = (uint64_t)fs::file_size(zip);
+            size_t tailLen = (size_t)min<uint64_t>(size, 22 + 65535);
+            tail.resize(tailLen);
+            in.seekg((streamoff)(size - tailLen));
+            in.read((char*)tail.data(), (streamsize)tailLen);
+            size_t eocd = string::npos;
+            for (size_t i = tailLen >= 22 ? tailLen - 22 + 1 : 0; i-- > 0;)
+                if (Get32(&tail[i]) == 0x06054b50) { eocd = i; break; }
+            if (eocd == string::npos) throw runtime_error("zip: end of central directory not found");
+            uint16_t count = Get16(&tail[eocd + 10]);
+            uint32_t cdSize = Get32(&tail[eocd + 12]), cdOff = Get32(&tail[eocd + 16]);
+            if ((uint64_t)cdOff + cdSize > size) throw runtime_error("zip: central directory out of range");
+            vector<uint8_t> cd(cdSize);
+            in.seekg(cdOff);
+            if (cdSize && !in.read((char*)cd.data(), cdSize)) throw runtime_error("zip: cannot read central directory");
+            for (size_t p = 0, k = 0; k < count; ++k) {
+                if (p + 46 > cd.size() || Get32(&cd[p]) != 0x02014b50) throw runtime_error("zip: corrupt central directory");
+                uint16_t nameLen = Get16(&cd[p + 28]), extraLen = Get16(&cd[p + 30]), commentLen = Get16(&cd[p + 32]);
+                if (p + 46 + nameLen > cd.size()) throw runtime_error("zip: corrupt central directory");
+                entries.push_back({ string((const char*)&cd[p + 46], nameLen), Get16(&cd[p + 10]),
+                    Get32(&cd[p + 16]), Get32(&cd[p + 20]), Get32(&cd[p + 24]), Get32(&cd[p + 42]) });
+                p += 46 + (size_t)nameLen + extraLen + commentLen;
+            }
+        }
+
+        return Run(entries.size(), threads, [&](size_t i, uint64_t& bytes) -> string {
+            const Entry& e = entries[i];
+            ifstream in(zip, ios::binary);
+            uint8_t lh[30];
+            in.seekg(e.offset);
+            if (!in.read((char*)lh, 30) || Get32(lh) != 0x04034b50) return e.name + ": bad local header";
+            in.seekg((streamoff)e.offset + 30 + Get16(lh + 26) + Get16(lh + 28));
+            if (e.method != 0 && e.method != 8) return e.name + ": unsupported method";
+            fs::path path = srcRoot / fs::path(u8string(e.name.begin(), e.name.end()));
+            error_code ec;
+            if ((uint64_t)fs::file_size(path, ec) != e.usize || ec) return e.name + ": size differs from source";
+            ifstream src(path, ios::binary);
+            if (!src) return e.name + ": cannot open source";
+
+            // 鵵һ: ۼ CRC-32 洢ֵ˶; Compare ģʽͬʱԴļȽ
+            uint32_t crc = 0;
+            uint64_t got = 0;
+            bool differs = false;
+            vector<uint8_t> block;
+            function<void(const uint8_t*, size_t)> onData = [&](const uint8_t* p, size_t n) {
+                crc = Crc32::Update(crc, p, n);
+                got += n;
+                if (mode != VerifyMode::Compare || differs) return;
+                if (got > e.usize) { differs = true; return; }
+                block.resize(n);
+                if (!src.read((char*)block.data(), (streamsize)n) || memcmp(block.data(), p, n) != 0) differs = true;
+            };
+            if (e.method == 8) Inflate::Decompress(in, e.csize, onData);
+            else ReadBlocks(in, e.csize, onData);
+            bytes += got;
+            if (got != e.usize || crc != e.crc) return e.name + ": CRC-32 mismatch";
+            if (mode == VerifyMode::Compare) {
+                bytes += got;
+                return differs ? e.name + ": differs from source" : string();
+            }
+
+            // Checksum: Դļ CRC-32, 鵵дֵȽ
+            uint32_t srcCrc = 0;
+            ReadBlocks(src, e.usize, [&](const uint8_t* p, size_t n) { srcCrc = Crc32::Update(srcCrc, p, n); });
+            bytes += e.usize;
+            return srcCrc == e.crc ? string() : e.name + ": differs from source";
+        });
+    }
+
+    static VerifyResult VerifySnapshot(const BackupStore& store, const string& snap, const fs::path& srcRoot, VerifyMode mode, int threads) {
+        return VerifyFiles(store, store.Load(snap), srcRoot, mode, threads);
+    }
+
+    // ֻУ嵥¼ ( BackupResult::changed), δļĿ֮ǰУ
+    static VerifyResult VerifyFiles(const BackupStore& store, const vector<BackupFile>& files, const fs::path& srcRoot, VerifyMode mode, int threads) {
+        return Run(files.size(), threads, [&](size_t i, uint64_t& bytes) -> string {
+            const BackupFile& f = files[i];
+            fs::path path = srcRoot / fs::path(u8string(f.name.begin(), f.name.end()));
+            if ((uint64_t)fs::file_size(path) != f.size) return f.name + ": size differs from source";
+            ifstream in(path, ios::binary);
+            if (!in) return f.name + ": cannot open source";
+            // ÿ鲻 GearChunker::MAX_SIZE, ໺嶼н
+            vector<uint8_t> src, chunk;
+            for (auto& c : f.chunks) {
+                src.resize(c.size);
+                if (!in.read((char*)src.data(), c.size)) return f.name + ": source truncated";
+                bytes += c.size;
+                if (mode == VerifyMode::Checksum) {
+                    // ԴݵĿ id 嵥Ƚ; ļֻ˶ԴС, ض
+                    if (!(ChunkId::Of(src.data(), src.size()) == c)) return f.name + ": chunk " + c.Hex() + " differs from source";
+                    error_code ec;
+                    if ((uint64_t)fs::file_size(store.ChunkPath(c), ec) != c.size || ec) return f.name + ": chunk " + c.Hex() + " missing or truncated";
+                    continue;
+                }
+                ifstream cs(store.ChunkPath(c), ios::binary);
+                chunk.resize(c.size);
+                if (!cs.read((char*)chunk.data(), c.size) || cs.peek() != EOF) return f.name + ": chunk " + c.Hex() + " missing or truncated";
+                bytes += c.size;
+                if (memcmp(src.data(), chunk.data(), c.size) != 0) return f.name + ": chunk " + c.Hex() + " differs from source";
+            }
+            return string();
+        });
+    }
+};
+
+// Full: ÿδ ZIP; Incremental: дȥؿ洢ɿ嵥
+enum class BackupMode { Full, Incremental };
+
+// --- Task A: ʵļ ---
+class TaskBackup : public ITask {
+    BackupMode mode;
+    VerifyMode verify;
+    int fullVerifyEvery;    // ģʽÿ N ݿУһ; 0 ʾֻУ鱾α仯ļ
+    int runCount = 0;
+
+    // Уͨɹ; һʱ׳, ɵʧܴ
+    static void Report(const VerifyResult& v, VerifyMode mode, const char* scope) {
+        ReportBuffer& msg = ReportBuffer::Begin();
+        msg.Text(v.mismatches ? "A: VERIFY FAILED (" : "A: Success! Verified (").Text(mode == VerifyMode::Compare ? "compare" : "checksum")
+            .Text(", ").Text(scope).Text(") ").UInt(v.files).Text(" file(s), ").Fixed(v.bytes / 1048576.0, 2).Text(" MB checked in ")
+            .Fixed(v.seconds * 1000.0, 1).Text(" ms (").Fixed(v.MBps(), 1).Text(" MB/s)");
+        if (v.mismatches) msg.Text(", ").UInt(v.mismatches).Text(" mismatch(es), first: ").Text(v.firstError);
+        msg.Text(".");
+        Log(msg.Str());
+        if (v.mismatches) throw runtime_error("backup verification failed: " + v.firstError);
+    }
+
+public:
+    explicit TaskBackup(BackupMode m = BackupMode::Full, VerifyMode v = VerifyMode::Checksum, int fullVerifyEvery = 0)
+        : mode(m), verify(v), fullVerifyEvery(max(0, fullVerifyEvery)) {}
+    string GetName() const override { return mode == BackupMode::Incremental ? "Task A: File Backup (incremental)" : "Task A: File Backup"; }
+    void Execute() override {
+        auto now = chrono::system_clock::to_time_t(chrono::system_clock::now());
+        struct tm t; localtime_s(&t, &now);
+        stringstream ss; ss << "backup_" << put_time(&t, "%Y%m%d_%H%M%S");
+        string snapName = ss.str();
+        string zipName = snapName + ".zip";
+        ++runCount;
+
+#ifdef _WIN32
+        fs::path srcDir = "C:\\Data";
+        fs::path destBase = "D:\\Backup";
+        const fs::path fallbackBase = "C:\\Backup";
+#else
+        fs::path srcDir = "data";
+        fs::path destBase = "backup";
+        const fs::path fallbackBase = fs::temp_directory_path() / "backup";
+#endif
+
+        Log("A: Init backup sequence...");
+
+        error_code ec;
+        if (!fs::exists(srcDir, ec)) {
+            Log("A: Creating " + srcDir.string() + " source...");
+            fs::create_directories(srcDir, ec);
+            ofstream ofs(srcDir / "test_file.txt");
+            ofs << "Test file for Project 3." << endl;
+            ofs.close();
+        }
+
+        if (!fs::is_directory(destBase, ec) && !fs::create_directories(destBase, ec)) {
+            Log("A: " + destBase.string() + " failed. Using " + fallbackBase.string() + "...");
+            destBase = fallbackBase;
+            fs::create_directories(destBase, ec);
+        }
+        int threads = (int)max(1u, thread::hardware_concurrency());
+
+        if (mode == BackupMode::Incremental) {
+            BackupStore store(destBase / "store");
+            Log("A: Snapshot -> " + (destBase / "store").string() + " (" + snapName + ")");
+            BackupResult r = store.Backup(srcDir, snapName, threads);
+
+            ReportBuffer& msg = ReportBuffer::Begin();
+            msg.Text("A: Snapshot done. ").UInt(r.files).Text(" file(s), ").UInt(r.changedFiles).Text(" changed, ")
+                .Fixed(r.scannedBytes / 1048576.0, 2).Text(" of ").Fixed(r.totalBytes / 1048576.0, 2).Text(" MB read, ")
+                .UInt(r.newChunks).Text(" new chunk(s) / ").Fixed(r.storedBytes / 1048576.0, 2).Text(" MB stored in ")
+                .Fixed(r.seconds * 1000.0, 1).Text(" ms.");
+            Log(msg.Str());
+            if (verify == VerifyMode::None) return;
+            if (fullVerifyEvery > 0 && runCount % fullVerifyEvery == 0)
+                Report(BackupVerifier::VerifySnapshot(store, snapName, srcDir, verify, threads), verify, "full snapshot");
+            else
+                Report(BackupVerifier::VerifyFiles(store, r.changed, srcDir, verify, threads), verify, "changed files");
+            return;
+        }
+
+        fs::path destFile = destBase / zipName;
+        Log("A: Zip -> " + destFile.string());
+        ZipResult r = ZipWriter::Write(destFile, SourceScanner::Walk(srcDir, threads), ZipMethod::Deflate, threads);
+
+        ReportBuffer& msg = ReportBuffer::Begin();
+        msg.Text("A: Zip done. ").UInt(r.files).Text(" file(s), ").Fixed(r.rawBytes / 1048576.0, 2).Text(" MB -> ")
+            .Fixed(r.zipBytes / 1048576.0, 2).Text(" MB in ").Fixed(r.seconds * 1000.0, 1).Text(" ms (")
+            .Fixed(r.MBps(), 1).Text(" MB/s, ").Int(threads).Text(" thread(s)).");
+        Log(msg.Str());
+        if (verify != VerifyMode::None) Report(BackupVerifier::VerifyZip(destFile, srcDir, verify, threads), verify, "archive");
+    }
+};
+
+// ==========================================
+// ˷ں (Task B)
+// ==========================================
+// 洢64 ֽڶ
+class AlignedMatrix {
+    struct AlignedDelete {
+        void operator()(double* p) const { ::operator delete[](p, align_val_t(64)); }
+    };
+    size_t rows = 0;
+    size_t cols = 0;
+    unique_ptr<double[], AlignedDelete> buf;
+
+public:
+    AlignedMatrix(size_t rows, size_t cols)
+        : rows(rows), cols(cols),
+          buf(static_cast<double*>(::operator new[](max<size_t>(1, rows * cols) * sizeof(double), align_val_t(64)))) {
+        memset(buf.get(), 0, rows * cols * sizeof(double));
+    }
+
+    size_t Rows() const { return rows; }
+    size_t Cols() const { return cols; }
+    double* Data() { return buf.get(); }
+    const double* Data() const { return buf.get(); }
+    double* Row(size_t i) { return buf.get() + i * cols; }
+    const double* Row(size_t i) const { return buf.get() + i * cols; }
+    double& At(size_t i, size_t j) { return buf[i * cols + j]; }
+    double At(size_t i, size_t j) const { return buf[i * cols + j]; }
+};
+
+// ֿ + Ĵֿ GEMM (BLIS ʽ): B Ϊ KC x NC , A Ϊ MC x KC ,
+// ΢ںÿμ MR x NR  C ӿ. ÿ C Ԫصۼ˳ֻȡ k ķֿ˳.
+class GemmKernel {
+public:
+    static constexpr size_t MR = 6;
+    static constexpr size_t NR = 8;
+    static constexpr size_t MC = 96;
+    static constexpr size_t KC = 256;
+    static constexpr size_t NC = 2048;
+
+    static const char* Isa() {
+#ifdef GEMM_USE_AVX2
+        return "avx2-fma";
+#else
+        return "scalar";
+#endif
+    }
+
+    //  A[ic.., pc..]  mc x kc : ÿ MR һ, ڰ k ,  MR в 0
+    static void PackA(const AlignedMatrix& A, size_t ic, size_t pc, size_t mc, size_t kc, double* out) {
+        for (size_t ir = 0; ir < mc; ir += MR) {
+            size_t mr = min(MR, mc - ir);
+            for (size_t k = 0; k < kc; ++k) {
+                for (size_t i = 0; i < mr; ++i) out[i] = A.At(ic + ir + i, pc + k);
+                for (size_t i = mr; i < MR; ++i) out[i] = 0.0;
+                out += MR;
+            }
+        }
+    }
+
+    //  B[pc.., jc..]  kc x nc : ÿ NR һ,  NR в 0
+    static void PackB(const AlignedMatrix& B, size_t pc, size_t jc, size_t kc, size_t nc, double* out) {
+        for (size_t jr = 0; jr < nc; jr += NR) {
+            size_t nr = min(NR, nc - jr);
+            for (size_t k = 0; k < kc; ++k) {
+                const double* src = B.Row(pc + k) + jc + jr;
+                for (size_t j = 0; j < nr; ++j) out[j] = src[j];
+                for (size_t j = nr; j < NR; ++j) out[j] = 0.0;
+                out += NR;
+            }
+        }
+    }
+
+    // C[0..mr, 0..nr] += Apanel * Bpanel
+    static void MicroKernel(size_t kc, const double* a, const double* b, double* c, size_t ldc, size_t mr, size_t nr) {
+        alignas(64) double acc[MR * NR];
+#ifdef GEMM_USE_AVX2
+        __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+        __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+        __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+        __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+        __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+        __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+        for (size_t k = 0; k < kc; ++k) {
+            __m256d b0 = _mm256_load_pd(b);
+            __m256d b1 = _mm256_load_pd(b + 4);
+            __m256d ai;
+            ai = _mm256_broadcast_sd(a + 0); c00 = _mm256_fmadd_pd(ai, b0, c00); c01 = _mm256_fmadd_pd(ai, b1, c01);
+            ai = _mm256_broadcast_sd(a + 1); c10 = _mm256_fmadd_pd(ai, b0, c10); c11 = _mm256_fmadd_pd(ai, b1, c11);
+            ai = _mm256_broadcast_sd(a + 2); c20 = _mm256_fmadd_pd(ai, b0, c20); c21 = _mm256_fmadd_pd(ai, b1, c21);
+            ai = _mm256_broadcast_sd(a + 3); c30 = _mm256_fmadd_pd(ai, b0, c30); c31 = _mm256_fmadd_pd(ai, b1, c31);
+            ai = _mm256_broadcast_sd(a + 4); c40 = _mm256_fmadd_pd(ai, b0, c40); c41 = _mm256_fmadd_pd(ai, b1, c41);
+            ai = _mm256_broadcast_sd(a + 5); c50 = _mm256_fmadd_pd(ai, b0, c50); c51 = _mm256_fmadd_pd(ai, b1, c51);
+            a += MR;
+            b += NR;
+        }
+        _mm256_store_pd(acc + 0, c00);  _mm256_store_pd(acc + 4, c01);
+        _mm256_store_pd(acc + 8, c10);  _mm256_store_pd(acc + 12, c11);
+        _mm256_store_pd(acc + 16, c20); _mm256_store_pd(acc + 20, c21);
+        _mm256_store_pd(acc + 24, c30); _mm256_store_pd(acc + 28, c31);
+        _mm256_store_pd(acc + 32, c40); _mm256_store_pd(acc + 36, c41);
+        _mm256_store_pd(acc + 40, c50); _mm256_store_pd(acc + 44, c51);
+#else
+        for (size_t i = 0; i < MR * NR; ++i) acc[i] = 0.0;
+        for (size_t k = 0; k < kc; ++k) {
+            for (size_t i = 0; i < MR; ++i) {
+                double ai = a[i];
+                for (size_t j = 0; j < NR; ++j) acc[i * NR + j] += ai * b[j];
+            }
+            a += MR;
+            b += NR;
+        }
+#endif
+        for (size_t i = 0; i < mr; ++i)
+            for (size_t j = 0; j < nr; ++j) c[i * ldc + j] += acc[i * NR + j];
+    }
+
+    //  C  [rowBegin, rowEnd) x [colBegin, colEnd) ӿ (C Ԥ), packA / packB Ϊ÷ṩĴ
+    static void MultiplyBlock(const AlignedMatrix& A, const AlignedMatrix& B, AlignedMatrix& C,
+        size_t rowBegin, size_t rowEnd, size_t colBegin, size_t colEnd, double* packA, double* packB) {
+        size_t K = A.Cols();
+        size_t ldc = C.Cols();
+        for (size_t jc = colBegin; jc < colEnd; jc += NC) {
+            size_t nc = min(NC, colEnd - jc);
+            for (size_t pc = 0; pc < K; pc += KC) {
+                size_t kc = min(KC, K - pc);
+                PackB(B, pc, jc, kc, nc, packB);
+                for (size_t ic = rowBegin; ic < rowEnd; ic += MC) {
+                    size_t mc = min(MC, rowEnd - ic);
+                    PackA(A, ic, pc, mc, kc, packA);
+                    for (size_t jr = 0; jr < nc; jr += NR) {
+                        size_t nr = min(NR, nc - jr);
+                        for (size_t ir = 0; ir < mc; ir += MR) {
+                            size_t mr = min(MR, mc - ir);
+                            MicroKernel(kc, packA + ir * kc, packB + jr * kc, C.Row(ic + ir) + jc + jr, ldc, mr, nr);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    static size_t RoundUp(size_t v, size_t m) { return (v + m - 1) / m * m; }
+
+    // ߳Ĵ (64 ֽڶ), ʵʳߴü, С󲻱ط
+    struct Workspace {
+        AlignedMatrix a;
+        AlignedMatrix b;
+        Workspace(size_t M, size_t K, size_t N)
+            : a(RoundUp(min(MC, M), MR), min(KC, K)), b(min(KC, K), RoundUp(min(NC, N), NR)) {}
+    };
+
+    // C = A * B
+    static void Multiply(const AlignedMatrix& A, const AlignedMatrix& B, AlignedMatrix& C) {
+        memset(C.Data(), 0, C.Rows() * C.Cols() * sizeof(double));
+        Workspace ws(A.Rows(), A.Cols(), B.Cols());
+        MultiplyBlock(A, B, C, 0, C.Rows(), 0, C.Cols(), ws.a.Data(), ws.b.Data());
+    }
+
+    // а汾:  C г TILE_M x TILE_N Ƭ, threads ߳ (߳) ȡƬ.
+    // k ķֿȫ̶ֹ, ÿԪصۼ˳뵥߳ȫͬ, ߳޹ءλһ.
+    static constexpr size_t TILE_M = 2 * MC;
+    static constexpr size_t TILE_N = 512;
+
+    static void MultiplyParallel(const AlignedMatrix& A, const AlignedMatrix& B, AlignedMatrix& C, int threads) {
+        size_t M = C.Rows(), N = C.Cols();
+        size_t tilesM = (M + TILE_M - 1) / TILE_M, tilesN = (N + TILE_N - 1) / TILE_N;
+        size_t total = tilesM * tilesN;
+        threads = (int)min<size_t>(max(1, threads), total);
+        if (threads <= 1) { Multiply(A, B, C); return; }
+
+        memset(C.Data(), 0, M * N * sizeof(double));
+        atomic<size_t> next{ 0 };
+        auto worker = [&]() {
+            Workspace ws(min(M, TILE_M), A.Cols(), min(N, TILE_N));
+            for (size_t t = next++; t < total; t = next++) {
+                size_t r0 = (t / tilesN) * TILE_M, c0 = (t % tilesN) * TILE_N;
+                MultiplyBlock(A, B, C, r0, min(M, r0 + TILE_M), c0, min(N, c0 + TILE_N), ws.a.Data(), ws.b.Data());
+            }
+        };
+        vector<thread> pool;
+        for (int i = 1; i < threads; ++i) pool.emplace_back(worker);
+        worker();
+        for (auto& t : pool) t.join();
+    }
+
+    // ѭ, 
+    static void MultiplyNaive(const AlignedMatrix& A, const AlignedMatrix& B, AlignedMatrix& C) {
+        size_t M = A.Rows(), K = A.Cols(), N = B.Cols();
+        for (size_t i = 0; i < M; ++i)
+            for (size_t j = 0; j < N; ++j) {
+                double sum = 0.0;
+                for (size_t k = 0; k < K; ++k) sum += A.At(i, k) * B.At(k, j);
+                C.At(i, j) = sum;
+            }
+    }
+};
+
+// --- Task B: Matrix Calc ---
+class TaskMatrix : public ITask {
+    int runCount = 0;
+    int N;
+    int threads;          // 0: ʹȫӲ߳
+    bool measureSpeedup;  // ÿζһ鵥̲߳Уλһ (); ÿ N ֻһ
+
+    //  N ĵ̺߳ʱ (ms): ״ζ߳ʱУ, ֮ļٱȶ
+    struct SerialBaseline {
+        mutex m;
+        unordered_map<int, double> ms;
+    };
+    static SerialBaseline& Baseline() {
+        static SerialBaseline b;
+        return b;
+    }
+
+public:
+    explicit TaskMatrix(int n = 200, int threads = 0, bool measureSpeedup = false)
+        : N(max(1, n)), threads(threads), measureSpeedup(measureSpeedup) {}
+    string GetName() const override { return "Task B: Matrix Calc (" + to_string(N) + "x" + to_string(N) + ")"; }
+
+    // ݴ: A ϽǵԤ C У. ڵǰ̵߳ ReportBuffer , ´ Begin ǰЧ
+    static const string& FormatPreview(const AlignedMatrix& A, int iteration, double checksum) {
+        int N = (int)A.Rows();
+        int P = min(N, 10);
+        ReportBuffer& rb = ReportBuffer::Begin();
+        rb.Banner(67, [&](ReportBuffer& r) {
+            r.Text(" TASK B: MATRIX PREVIEW (Top-Left ").Int(P).Text("x").Int(P).Text(" Block) - Iteration: ").Int(iteration);
+        });
+        rb.GridRule(6, P, 5);
+        for (int i = 0; i < P; ++i) {
+            rb.Text(" R").Int(i, 2).Text("  ");
+            for (int j = 0; j < P; ++j) rb.Text("|").Fixed(A.At(i, j), 1, 5);
+            rb.Text("|").NewLine();
+            rb.GridRule(6, P, 5);
+        }
+        rb.Text(" (... ").Int(N).Text("x").Int(N).Text(" Full Data Hidden ...)").NewLine();
+        rb.Text(" C = A x B  checksum: ").Fixed(checksum, 3).NewLine();
+        return rb.Str();
+    }
+    void Execute() override {
+        Log("B: Generating Matrix...");
+
+        // ԭ rand() % 100 / 10.0 ͬȡֵ: 0.0 .. 9.9
+        FastRng& rng = RandomService::Acquire(RandomService::StreamKey('B', (uint32_t)runCount));
+        AlignedMatrix A(N, N), B(N, N), C(N, N);
+        vector<int> row(N);
+        for (AlignedMatrix* M : { &A, &B })
+            for (int i = 0; i < N; ++i) {
+                rng.FillInt(row.data(), row.size(), 0, 99);
+                for (int j = 0; j < N; ++j) M->At(i, j) = row[j] / 10.0;
+            }
+
+        int nThreads = threads > 0 ? threads : max(1, (int)thread::hardware_concurrency());
+        auto start = chrono::high_resolution_clock::now();
+        GemmKernel::MultiplyParallel(A, B, C, nThreads);
+        auto end = chrono::high_resolution_clock::now();
+        chrono::duration<double, milli> elapsed = end - start;
+        double gflops = 2.0 * N * N * N / max(elapsed.count(), 1e-6) / 1e6;
+
+        double serialMs = nThreads == 1 ? elapsed.count() : 0;
+        bool identical = true;
+        if (!serialMs && !measureSpeedup) {
+            SerialBaseline& b = Baseline();
+            lock_guard<mutex> lock(b.m);
+            auto it = b.ms.find(N);
+            if (it != b.ms.end()) serialMs = it->second;
+        }
+        if (!serialMs) {
+            AlignedMatrix ref(N, N);
+            auto s0 = chrono::high_resolution_clock::now();
+            GemmKernel::Multiply(A, B, ref);
+            chrono::duration<double, milli> serial = chrono::high_resolution_clock::now() - s0;
+            serialMs = serial.count();
+            identical = memcmp(ref.Data(), C.Data(), (size_t)N * N * sizeof(double)) == 0;
+            SerialBaseline& b = Baseline();
+            lock_guard<mutex> lock(b.m);
+            b.ms[N] = serialMs;
+        }
+        double speedup = serialMs / max(elapsed.count(), 1e-6);
+
+        double checksum = 0;
+        for (int i = 0; i < N; ++i)
+            for (int j = 0; j < N; ++j) checksum += C.At(i, j);
+
+        LogData(FormatPreview(A, runCount++, checksum));
+
+        ReportBuffer& msg = ReportBuffer::Begin();
+        msg.Text("B: Calc finished in ").Fixed(elapsed.count(), 2).Text(" ms (").Fixed(gflops, 2).Text(" GFLOPS, ")
+            .Text(GemmKernel::Isa()).Text(", ").Int(nThreads).Text(" thread(s)");
+        msg.Text(", speedup ").Fixed(speedup, 2).Text("x vs 1 thread").Text(identical ? "" : ", RESULT MISMATCH");
+        msg.Text(").");
+        Log(msg.Str());
+    }
+};
+
+// ==========================================
+// HTTP ͻ (Task C)
+// ==========================================
+// ׽ּݲ: Winsock (WSAPoll)  POSIX (poll) һ׵
+#ifdef _WIN32
+typedef SOCKET NetSocket;
+static const NetSocket NET_INVALID = INVALID_SOCKET;
+static const int NET_SEND_FLAGS = 0;
+static int NetPoll(pollfd* fds, size_t n, int ms) { return WSAPoll(fds, (ULONG)n, ms); }
+static void NetClose(NetSocket s) { closesocket(s); }
+static bool NetNonBlocking(NetSocket s) { u_long on = 1; return ioctlsocket(s, FIONBIO, &on) == 0; }
+static bool NetWouldBlock() { int e = WSAGetLastError(); return e == WSAEWOULDBLOCK || e == WSAEINPROGRESS || e == WSAEALREADY; }
+static void NetStartup() { static WSADATA wsa; static int rc = WSAStartup(MAKEWORD(2, 2), &wsa); (void)rc; }
+#else
+typedef int NetSocket;
+static const NetSocket NET_INVALID = -1;
+static const int NET_SEND_FLAGS = MSG_NOSIGNAL;
+static int NetPoll(pollfd* fds, size_t n, int ms) { return poll(fds, (nfds_t)n, ms); }
+static void NetClose(NetSocket s) { close(s); }
+static bool NetNonBlocking(NetSocket s) { int f = fcntl(s, F_GETFL, 0); return f >= 0 && fcntl(s, F_SETFL, f | O_NONBLOCK) == 0; }
+static bool NetWouldBlock() { return errno == EWOULDBLOCK || errno == EAGAIN || errno == EINPROGRESS; }
+static void NetStartup() {}
+#endif
+
+struct HttpResponse {
+    int status = 0;                             // 0 ʾδõӦ, ԭ error
+    vector<pair<string, string>> headers;       // ΪСд
+    string body;
+    string error;
+    double latencyMs = 0;
+    bool reused = false;                        // Ƿ
+    bool notModified = false;                   // ˷ 304, body ȡ HttpCache
+
+    const string* Header(const string& lowerName) const {
+        for (auto& h : headers) if (h.first == lowerName) return &h.second;
+        return nullptr;
+    }
+};
+
+using HttpCallback = function<void(HttpResponse&)>;
+
+struct HttpClientOptions {
+    size_t maxConnsPerHost = 8;
+    size_t maxPipeline = 4;                     // ѷδɵ
+    chrono::milliseconds idleTimeout = chrono::milliseconds(30000);
+    size_t maxResponseBytes = 16 * 1024 * 1024;
+};
+
+struct HttpClientStats {
+    uint64_t requests = 0, failures = 0, timeouts = 0;
+    uint64_t connects = 0, reused = 0;
+    uint64_t bytesIn = 0, bytesOut = 0;
+};
+
+//  HTTP/1.1 ͻ: ¼ѭ߳ poll ȫ, ߳.
+// ÿά keep-alive ӳ, ˮ߷ (ƥӦ); ÿжʱ.
+// ;رʱ, δյӦ GET Ŷ ( 3 γ). ص¼ѭִ߳, Ӧ췵.
+// ֧ http://;  host:port . IP ѭֱ߳ת;  getaddrinfo
+// , ߳, ڼڶ (ճƳʱ), շӰ.
+class HttpClient {
+    using Clock = chrono::steady_clock;
+
+    struct Request {
+        string hostKey, host, port;
+        string head;                            // л
+        HttpCallback cb;
+        Clock::time_point start, deadline;
+        int attempts = 0;
+        bool reused = false;
+    };
+    using ReqPtr = unique_ptr<Request>;
+
+    struct Conn {
+        NetSocket fd = NET_INVALID;
+        bool connecting = true;
+        bool closeAfter = false;                // Ҫر, ӦԹرӶ
+        string out;
+        size_t outOff = 0;
+        string in;
+        deque<ReqPtr> inflight;
+        uint64_t served = 0;
+        Clock::time_point idleSince;
+    };
+
+    struct Host {
+        deque<ReqPtr> pending;
+        vector<unique_ptr<Conn>> conns;
+        sockaddr_storage addr{};
+        socklen_t addrLen = 0;
+        bool resolving = false;
+    };
+
+    struct Query {
+        string key, host, port;
+    };
+    struct Resolved {
+        string key;
+        sockaddr_storage addr{};
+        socklen_t addrLen = 0;
+        string error;
+    };
+
+    enum class Parse { Incomplete, Done, Error };
+
+    mutex m;
+    vector<ReqPtr> incoming;
+    HttpClientOptions opt;
+    HttpClientStats stats;
+    bool running = false;
+    thread loop;
+    NetSocket wakeFd = NET_INVALID;
+    static constexpr int RESOLVER_THREADS = 4;
+    vector<thread> resolvers;
+    condition_variable resolverCv;
+    deque<Query> lookups;           // ,  m 
+    vector<Resolved> resolved;      // ,  m , ѭ߳ȡ
+
+    // ½ѭ̷߳
+    unordered_map<string, Host> hosts;
+    vector<pair<ReqPtr, HttpResponse>> completed;
+    HttpClientOptions loopOpt;
+
+    static string Lower(string s) { for (auto& c : s) c = (char)tolower((unsigned char)c); return s; }
+
+    static bool ParseUrl(const string& url, string& host, string& port, string& path) {
+        const string scheme = "http://";
+        if (url.compare(0, scheme.size(), scheme) != 0) return false;
+        size_t hs = scheme.size(), ps = url.find('/', hs);
+        string authority = url.substr(hs, ps == string::npos ? string::npos : ps - hs);
+        path = ps == string::npos ? "/" : url.substr(ps);
+        size_t colon = authority.rfind(':');
+        host = colon == string::npos ? authority : authority.substr(0, colon);
+        port = colon == string::npos ? "80" : authority.substr(colon + 1);
+        return !host.empty() && !port.empty();
+    }
+
+    //  buf ͷһӦ; eof ʾѹر (ԹرնӦݴ˽)
+    static Parse ParseResponse(const string& buf, bool eof, HttpResponse& r, size_t& used, bool& closeConn) {
+        size_t he = buf.find("\r\n\r\n");
+        if (he == string::npos) return (eof || buf.size() > 64 * 1024) ? Parse::Error : Parse::Incomplete;
+        if (buf.compare(0, 7, "HTTP/1.") != 0 || he < 12) return Parse::Error;
+        bool http10 = buf[7] == '0';
+        r.status = atoi(buf.c_str() + 9);
+        r.headers.clear();
+        for (size_t p = buf.find("\r\n") + 2; p < he;) {
+            size_t e = buf.find("\r\n", p);
+            size_t colon = buf.find(':', p);
+            if (colon != string::npos && colon < e) {
+                size_t v = colon + 1;
+                while (v < e && (buf[v] == ' ' || buf[v] == '\t')) ++v;
+                size_t ve = e;
+                while (ve > v && (buf[ve - 1] == ' ' || buf[ve - 1] == '\t')) --ve;
+                r.headers.emplace_back(Lower(buf.substr(p, colon - p)), buf.substr(v, ve - v));
+            }
+            p = e + 2;
+        }
+        const string* conn = r.Header("connection");
+        string connLower = conn ? Lower(*conn) : string();
+        closeConn = http10 ? connLower.find("keep-alive") == string::npos : connLower.find("close") != string::npos;
+
+        size_t body = he + 4;
+        r.body.clear();
+        if (r.status < 200 || r.status == 204 || r.status == 304) { used = body; return Parse::Done; }
+
+        const string* te = r.Header("transfer-encoding");
+        if (te && Lower(*te).find("chunked") != string::npos) {
+            size_t p = body;
+            for (;;) {
+                size_t le = buf.find("\r\n", p);
+                if (le == string::npos) return Parse::Incomplete;
+                size_t size = 0;
+                auto res = from_chars(buf.data() + p, buf.data() + le, size, 16);
+                if (res.ptr == buf.data() + p) return Parse::Error;
+                p = le + 2;
+                if (size == 0) {
+                    //  trailer, Կн
+                    for (;;) {
+                        size_t te2 = buf.find("\r\n", p);
+                        if (te2 == string::npos) return Parse::Incomplete;
+                        bool empty = te2 == p;
+                        p = te2 + 2;
+                        if (empty) { used = p; return Parse::Done; }
+                    }
+                }
+                if (buf.size() < p + size + 2) return Parse::Incomplete;
+                r.body.append(buf, p, size);
+                p += size + 2;
+            }
+        }
+        if (const string* cl = r.Header("content-length")) {
+            size_t len = 0;
+            if (from_chars(cl->data(), cl->data() + cl->size(), len).ec != errc()) return Parse::Error;
+            if (buf.size() < body + len) return eof ? Parse::Error : Parse::Incomplete;
+            r.body.assign(buf, body, len);
+            used = body + len;
+            return Parse::Done;
+        }
+        if (!eof) return Parse::Incomplete;
+        r.body.assign(buf, body, string::npos);
+        used = buf.size();
+        closeConn = true;
+        return Parse::Done;
+    }
+
+    void Complete(ReqPtr req, HttpResponse r) {
+        r.latencyMs = chrono::duration<double, milli>(Clock::now() - req->start).count();
+        r.reused = req->reused;
+        completed.emplace_back(move(req), move(r));
+    }
+
+    void Fail(ReqPtr req, const string& error) {
+        HttpResponse r;
+        r.error = error;
+        Complete(move(req), move(r));
+    }
+
+    // ر; δյӦԭ˳Żض
+    void CloseConn(Host& h, Conn& c, const string& reason) {
+        if (c.fd != NET_INVALID) NetClose(c.fd);
+        c.fd = NET_INVALID;
+        while (!c.inflight.empty()) {
+            ReqPtr r = move(c.inflight.back());
+            c.inflight.pop_back();
+            if (++r->attempts < 3) h.pending.push_front(move(r));
+            else Fail(move(r), reason);
+        }
+    }
+
+    // numericOnly ʱֻ IP , ѯ DNS, 
+    static bool LookupAddr(const string& host, const string& port, bool numericOnly, sockaddr_storage& addr, socklen_t& len) {
+        addrinfo hints{}, * ai = nullptr;
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        if (numericOnly) hints.ai_flags = AI_NUMERICHOST;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &ai) != 0 || !ai) return false;
+        memcpy(&addr, ai->ai_addr, ai->ai_addrlen);
+        len = (socklen_t)ai->ai_addrlen;
+        freeaddrinfo(ai);
+        return true;
+    }
+
+    void ResolverMain() {
+        unique_lock<mutex> lk(m);
+        for (;;) {
+            resolverCv.wait(lk, [this] { return !running || !lookups.empty(); });
+            if (!running) return;
+            Query q = move(lookups.front());
+            lookups.pop_front();
+            lk.unlock();
+
+            Resolved res;
+            res.key = move(q.key);
+            if (!LookupAddr(q.host, q.port, false, res.addr, res.addrLen)) res.error = "cannot resolve " + q.host;
+
+            lk.lock();
+            resolved.push_back(move(res));
+            Wake();
+        }
+    }
+
+    // ѭ߳:  true ʾַѿ; ѽ߳ (ÿͬʱֻһڽ)
+    bool Resolve(const string& key, Host& h) {
+        if (h.addrLen) return true;
+        if (h.resolving || h.pending.empty()) return false;
+        const Request& r = *h.pending.front();
+        if (LookupAddr(r.host, r.port, true, h.addr, h.addrLen)) return true;
+        h.resolving = true;
+        {
+            lock_guard<mutex> lk(m);
+            lookups.push_back({ key, r.host, r.port });
+        }
+        resolverCv.notify_one();
+        return false;
+    }
+
+    void ApplyResolved(vector<Resolved>& results) {
+        for (auto& res : results) {
+            auto it = hosts.find(res.key);
+            if (it == hosts.end()) continue;
+            Host& h = it->second;
+            h.resolving = false;
+            if (res.error.empty()) {
+                h.addr = res.addr;
+                h.addrLen = res.addrLen;
+                continue;
+            }
+            while (!h.pending.empty()) { Fail(move(h.pending.front()), res.error); h.pending.pop_front(); }
+        }
+        results.clear();
+    }
+
+    Conn* Open(Host& h) {
+        NetSocket fd = socket(h.addr.ss_family, SOCK_STREAM, IPPROTO_TCP);
+        if (fd == NET_INVALID) return nullptr;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+        if (!NetNonBlocking(fd)) { NetClose(fd); return nullptr; }
+        auto c = make_unique<Conn>();
+        c->fd = fd;
+        if (connect(fd, (const sockaddr*)&h.addr, h.addrLen) == 0) c->connecting = false;
+        else if (!NetWouldBlock()) { NetClose(fd); h.addrLen = 0; return nullptr; }
+        c->idleSince = Clock::now();
+        h.conns.push_back(move(c));
+        lock_guard<mutex> lk(m);
+        ++stats.connects;
+        return h.conns.back().get();
+    }
+
+    // Ѵ䵽: ;ٵ, ;δʱ½
+    void Assign(const string& key, Host& h) {
+        if (!Resolve(key, h)) return;
+        while (!h.pending.empty()) {
+            Conn* best = nullptr;
+            for (auto& c : h.conns) {
+                if (c->fd == NET_INVALID || c->closeAfter || c->inflight.size() >= loopOpt.maxPipeline) continue;
+                if (!best || c->inflight.size() < best->inflight.size()) best = c.get();
+            }
+            if ((!best || !best->inflight.empty()) && h.conns.size() < loopOpt.maxConnsPerHost) {
+                if (Conn* fresh = Open(h)) best = fresh;
+                else if (!best) {
+                    while (!h.pending.empty()) { Fail(move(h.pending.front()), "connect to " + key + " failed"); h.pending.pop_front(); }
+                    return;
+                }
+            }
+            if (!best) return;
+            ReqPtr r = move(h.pending.front());
+            h.pending.pop_front();
+            r->reused = best->served > 0 || !best->inflight.empty();
+            best->out += r->head;
+            best->inflight.push_back(move(r));
+        }
+    }
+
+    void Flush(Host& h, Conn& c) {
+        while (c.outOff < c.out.size()) {
+            int n = (int)send(c.fd, c.out.data() + c.outOff, (int)(c.out.size() - c.outOff), NET_SEND_FLAGS);
+            if (n > 0) { c.outOff += (size_t)n; lock_guard<mutex> lk(m); stats.bytesOut += (uint64_t)n; continue; }
+            if (n < 0 && NetWouldBlock()) return;
+            CloseConn(h, c, "send failed");
+            return;
+        }
+        c.out.clear();
+        c.outOff = 0;
+    }
+
+    void Read(Host& h, Conn& c) {
+        char buf[64 * 1024];
+        bool eof = false;
+        for (;;) {
+            int n = (int)recv(c.fd, buf, (int)sizeof(buf), 0);
+            if (n > 0) { c.in.append(buf, (size_t)n); lock_guard<mutex> lk(m); stats.bytesIn += (uint64_t)n; continue; }
+            if (n == 0) { eof = true; break; }
+            if (NetWouldBlock()) break;
+            CloseConn(h, c, "recv failed");
+            return;
+        }
+        if (c.in.size() > loopOpt.maxResponseBytes) { CloseConn(h, c, "response too large"); return; }
+
+        while (!c.inflight.empty()) {
+            HttpResponse r;
+            size_t used = 0;
+            bool closeConn = false;
+            Parse p = ParseResponse(c.in, eof, r, used, closeConn);
+            if (p == Parse::Incomplete) break;
+            if (p == Parse::Error) { CloseConn(h, c, "malformed response"); return; }
+            c.in.erase(0, used);
+            if (r.status < 200) continue;   // 100 Continue мӦ
+            ReqPtr req = move(c.inflight.front());
+            c.inflight.pop_front();
+            ++c.served;
+            Complete(move(req), move(r));
+            if (closeConn) { c.closeAfter = true; break; }
+        }
+        if (c.inflight.empty()) c.idleSince = Clock::now();
+        if (eof || c.closeAfter) CloseConn(h, c, eof ? "connection closed by server" : "connection closed");
+    }
+
+    void Expire(Clock::time_point now) {
+        for (auto& [key, h] : hosts) {
+            for (auto it = h.pending.begin(); it != h.pending.end();) {
+                if ((*it)->deadline <= now) {
+                    { lock_guard<mutex> lk(m); ++stats.timeouts; }
+                    Fail(move(*it), "timeout");
+                    it = h.pending.erase(it);
+                }
+                else ++it;
+            }
+            for (auto& c : h.conns) {
+                if (c->fd == NET_INVALID) continue;
+                bool expired = false;
+                for (auto& r : c->inflight) expired |= r->deadline <= now;
+                if (expired) {
+                    // ˮϵӦ򵽴, ʱֻܻ֮ط
+                    deque<ReqPtr> keep;
+                    for (auto& r : c->inflight) {
+                        if (r->deadline <= now) { { lock_guard<mutex> lk(m); ++stats.timeouts; } Fail(move(r), "timeout"); }
+                        else keep.push_back(move(r));
+                    }
+                    c->inflight = move(keep);
+                    CloseConn(h, *c, "timeout");
+                }
+                else if (c->inflight.empty() && !c->connecting && now - c->idleSince > loopOpt.idleTimeout) {
+                    CloseConn(h, *c, "idle");
+                }
+            }
+            h.conns.erase(remove_if(h.conns.begin(), h.conns.end(), [](const unique_ptr<Conn>& c) { return c->fd == NET_INVALID; }), h.conns.end());
+        }
+    }
+
+    int NextTimeoutMs(Clock::time_point now) const {
+        auto next = now + chrono::milliseconds(250);
+        for (auto& [key, h] : hosts) {
+            for (auto& r : h.pending) next = min(next, r->deadline);
+            for (auto& c : h.conns) for (auto& r : c->inflight) next = min(next, r->deadline);
+        }
+        return (int)max<long long>(0, chrono::duration_cast<chrono::milliseconds>(next - now).count() + 1);
+    }
+
+    void Deliver() {
+        {
+            lock_guard<mutex> lk(m);
+            for (auto& [req, r] : completed) {
+                ++stats.requests;
+                if (r.status == 0) ++stats.failures;
+                if (r.reused) ++stats.reused;
+            }
+        }
+        auto batch = move(completed);
+        completed.clear();
+        for (auto& [req, r] : batch) req->cb(r);
+    }
+
+    void Loop() {
+        vector<pollfd> fds;
+        vector<pair<Host*, Conn*>> polled;
+        vector<Resolved> results;
+        for (;;) {
+            {
+                lock_guard<mutex> lk(m);
+                if (!running) break;
+                loopOpt = opt;
+                for (auto& r : incoming) {
+                    string key = r->hostKey;
+                    hosts[key].pending.push_back(move(r));
+                }
+                incoming.clear();
+                results.swap(resolved);
+            }
+            ApplyResolved(results);
+            auto now = Clock::now();
+            Expire(now);
+            for (auto& [key, h] : hosts) Assign(key, h);
+
+            fds.clear();
+            polled.clear();
+            fds.push_back({ wakeFd, POLLIN, 0 });
+            for (auto& [key, h] : hosts) {
+                for (auto& c : h.conns) {
+                    if (c->fd == NET_INVALID) continue;
+                    short ev = POLLIN;
+                    if (c->connecting || c->outOff < c->out.size()) ev |= POLLOUT;
+                    fds.push_back({ c->fd, ev, 0 });
+                    polled.emplace_back(&h, c.get());
+                }
+            }
+            Deliver();
+            NetPoll(fds.data(), fds.size(), NextTimeoutMs(Clock::now()));
+
+            if (fds[0].revents & POLLIN) {
+                char drain[256];
+                while (recv(wakeFd, drain, (int)sizeof(drain), 0) > 0) {}
+            }
+            for (size_t i = 0; i < polled.size(); ++i) {
+                short re = fds[i + 1].revents;
+                Host& h = *polled[i].first;
+                Conn& c = *polled[i].second;
+                if (!re || c.fd == NET_INVALID) continue;
+                if (c.connecting) {
+                    int err = 0;
+                    socklen_t len = sizeof(err);
+                    getsockopt(c.fd, SOL_SOCKET, SO_ERROR, (char*)&err, &len);
+                    if (err || (re & POLLNVAL)) { CloseConn(h, c, "connect failed"); continue; }
+                    if (!(re & POLLOUT)) continue;
+                    c.connecting = false;
+                }
+                if (re & POLLOUT) Flush(h, c);
+                if (c.fd != NET_INVALID && (re & (POLLIN | POLLHUP | POLLERR))) Read(h, c);
+            }
+            Deliver();
+        }
+
+        for (auto& [key, h] : hosts) {
+            for (auto& c : h.conns) CloseConn(h, *c, "client stopped");
+            while (!h.pending.empty()) { Fail(move(h.pending.front()), "client stopped"); h.pending.pop_front(); }
+        }
+        hosts.clear();
+        Deliver();
+    }
+
+    // ׽: 󶨵صַ UDP ׽, дһֽڼɴ poll
+    bool StartLocked() {
+        NetStartup();
+        wakeFd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (wakeFd == NET_INVALID) return false;
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(a);
+        if (::bind(wakeFd, (sockaddr*)&a, sizeof(a)) != 0 || getsockname(wakeFd, (sockaddr*)&a, &len) != 0
+            || connect(wakeFd, (sockaddr*)&a, sizeof(a)) != 0 || !NetNonBlocking(wakeFd)) {
+            NetClose(wakeFd);
+            wakeFd = NET_INVALID;
+            return false;
+        }
+        running = true;
+        loop = thread(&HttpClient::Loop, this);
+        for (int i = 0; i < RESOLVER_THREADS; ++i) resolvers.emplace_back(&HttpClient::ResolverMain, this);
+        return true;
+    }
+
+    void Wake() { char b = 1; send(wakeFd, &b, 1, 0); }
+
+public:
+    static HttpClient& Instance() { static HttpClient c; return c; }
+    ~HttpClient() { Shutdown(); }
+
+    void Configure(const HttpClientOptions& o) {
+        lock_guard<mutex> lk(m);
+        opt = o;
+    }
+
+    HttpClientStats Stats() {
+        lock_guard<mutex> lk(m);
+        return stats;
+    }
+
+    // 첽 GET; cb ǡõһ (ɹHTTP ʧ)
+    void Get(const string& url, chrono::milliseconds timeout, HttpCallback cb, const vector<pair<string, string>>& headers = {}) {
+        auto r = make_unique<Request>();
+        string path;
+        if (!ParseUrl(url, r->host, r->port, path)) {
+            HttpResponse resp;
+            resp.error = "unsupported url: " + url;
+            cb(resp);
+            return;
+        }
+        r->hostKey = r->host + ":" + r->port;
+        r->head = "GET " + path + " HTTP/1.1\r\nHost: " + (r->port == "80" ? r->host : r->hostKey)
+            + "\r\nUser-Agent: TaskScheduler/1.0\r\nAccept: */*\r\n";
+        for (auto& h : headers) r->head += h.first + ": " + h.second + "\r\n";
+        r->head += "\r\n";
+        r->cb = move(cb);
+        r->start = Clock::now();
+        r->deadline = r->start + timeout;
+        bool started;
+        {
+            lock_guard<mutex> lk(m);
+            started = running || StartLocked();
+            if (started) incoming.push_back(move(r));
+        }
+        if (!started) {
+            HttpResponse resp;
+            resp.error = "network unavailable";
+            r->cb(resp);
+            return;
+        }
+        Wake();
+    }
+
+    void Shutdown() {
+        {
+            lock_guard<mutex> lk(m);
+            if (!running) return;
+            running = false;
+        }
+        Wake();
+        resolverCv.notify_all();
+        if (loop.joinable()) loop.join();
+        for (auto& t : resolvers) t.join();     // е getaddrinfo ȷ
+        resolvers.clear();
+        lookups.clear();
+        resolved.clear();
+        NetClose(wakeFd);
+        wakeFd = NET_INVALID;
+    }
+};
+
+// 󻺴:  URL  ETag / Last-Modified  200 Ӧ, ٴʱ
+// If-None-Match / If-Modified-Since; ˷ 304 ʱӦ, ֱû (notModified = true).
+//  body ֽ, ʱ̭δõĿ;  body  1/4 Ĳ.
+struct HttpCacheStats {
+    uint64_t hits = 0;          // 304, ɻӦ
+    uint64_t misses = 0;        // ޻򻺴ѹ, յӦ
+    uint64_t evictions = 0;
+    uint64_t bytesSaved = 0;    //  304 δ body ֽ
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+class HttpCache {
+    struct Entry {
+        string etag, lastModified;
+        int status = 200;
+        vector<pair<string, string>> headers;
+        string body;
+        list<string>::iterator lru;
+    };
+
+    mutex m;
+    size_t capacity;
+    size_t bytes = 0;
+    list<string> order;                         // ͷΪʹ
+    unordered_map<string, Entry> entries;
+    HttpCacheStats stats;
+
+    void Touch(Entry& e) { order.splice(order.begin(), order, e.lru); }
+
+    void Store(const string& url, const HttpResponse& r) {
+        const string* etag = r.Header("etag");
+        const string* lm = r.Header("last-modified");
+        auto it = entries.find(url);
+        if (it != entries.end()) {
+            bytes -= it->second.body.size();
+            order.erase(it->second.lru);
+            entries.erase(it);
+        }
+        if ((!etag && !lm) || r.body.size() > capacity / 4) return;
+        Entry& e = entries[url];
+        e.etag = etag ? *etag : string();
+        e.lastModified = lm ? *lm : string();
+        e.status = r.status;
+        e.headers = r.headers;
+        e.body = r.body;
+        order.push_front(url);
+        e.lru = order.begin();
+        bytes += e.body.size();
+        while (bytes > capacity && !order.empty()) {
+            auto victim = entries.find(order.back());
+            bytes -= victim->second.body.size();
+            entries.erase(victim);
+            order.pop_back();
+            ++stats.evictions;
+        }
+    }
+
+public:
+    explicit HttpCache(size_t capacityBytes = 8 * 1024 * 1024) : capacity(capacityBytes) {}
+
+    static HttpCache& Instance() { static HttpCache c; return c; }
+
+    void SetCapacity(size_t capacityBytes) {
+        lock_guard<mutex> lk(m);
+        capacity = capacityBytes;
+    }
+
+    HttpCacheStats Stats() {
+        lock_guard<mutex> lk(m);
+        HttpCacheStats s = stats;
+        s.entries = entries.size();
+        s.bytes = bytes;
+        return s;
+    }
+
+    //  HttpClient::Get ͬԼ;  304 ʱصյ״̬롢ͷ body
+    void Get(const string& url, chrono::milliseconds timeout, HttpCallback cb) {
+        vector<pair<string, string>> headers;
+        {
+            lock_guard<mutex> lk(m);
+            auto it = entries.find(url);
+            if (it != entries.end()) {
+                if (!it->second.etag.empty()) headers.emplace_back("If-None-Match", it->second.etag);
+                if (!it->second.lastModified.empty()) headers.emplace_back("If-Modified-Since", it->second.lastModified);
+            }
+        }
+        HttpClient::Instance().Get(url, timeout, [this, url, cb = move(cb)](HttpResponse& r) {
+            {
+                lock_guard<mutex> lk(m);
+                auto it = entries.find(url);
+                if (r.status == 304 && it != entries.end()) {
+                    Entry& e = it->second;
+                    Touch(e);
+                    ++stats.hits;
+                    stats.bytesSaved += e.body.size();
+                    r.status = e.status;
+                    r.headers = e.headers;
+                    r.body = e.body;
+                    r.notModified = true;
+                }
+                else if (r.status == 200) {
+                    ++stats.misses;
+                    Store(url, r);
+                }
+                else if (r.status != 0) {
+                    ++stats.misses;
+                }
+            }
+            cb(r);
+        }, headers);
+    }
+};
+
+// --- Task D: Reminder ---
+class TaskReminder : public ITask {
+public:
+    string GetName() const override { return "Task D: Reminder"; }
+    void Execute() override {
+#ifdef _WIN32
+        thread([]() {
+            MessageBoxA(hGlobalWnd, "Ϣ 5 ", "", MB_OK | MB_ICONINFORMATION | MB_SYSTEMMODAL);
+            }).detach();
+        Log("D: Popup displayed.");
+#else
+        Log("D: Reminder - take a 5 minute break.");
+#endif
+    }
+};
+
+// --- Task G: ⲿ (첽) ---
+// Ѳд־,  200 
+static void LogProcessOutput(const string& text, bool truncated, const string& prefix) {
+    constexpr int MAX_LINES = 200;
+    int lines = 0;
+    size_t pos = 0;
+    while (pos < text.size() && lines < MAX_LINES) {
+        size_t end = text.find('\n', pos);
+        if (end == string::npos) end = text.size();
+        size_t len = end - pos;
+        if (len && text[pos + len - 1] == '\r') --len;
+        Log(prefix + text.substr(pos, len));
+        ++lines;
+        pos = end + 1;
+    }
+    if (pos < text.size() || truncated) Log(prefix + "... (output truncated)");
+}
+
+#ifdef _WIN32
+// Windows: CreateProcess ӽ, stdout / stderr ض򵽹رռɾʱļ (ӽֻ̳);
+// ̳ͨ߳صȴ (RegisterWaitForSingleObject) ֪˳ʱ, ӽڼ䲻ռõ worker.
+// ̳߳ذÿ߳ 63 ϲȴ, ٸӽֻȴ߳.
+class TaskProcess : public ITask {
+    static constexpr DWORD MAX_CAPTURE = 64 * 1024;     // ÿ¼ֽ
+
+    string label;
+    string commandLine;
+    DWORD timeoutMs;
+
+    struct Run {
+        mutex m;                // ֤ص wait д֮Ŵ
+        HANDLE process = NULL;
+        HANDLE out = INVALID_HANDLE_VALUE;
+        HANDLE err = INVALID_HANDLE_VALUE;
+        HANDLE wait = NULL;
+        string label;
+        DWORD timeoutMs = INFINITE;
+        TaskDone done;
+
+        ~Run() {
+            if (process) CloseHandle(process);
+            if (out != INVALID_HANDLE_VALUE) CloseHandle(out);
+            if (err != INVALID_HANDLE_VALUE) CloseHandle(err);
+        }
+    };
+
+    static HANDLE TempFile() {
+        char dir[MAX_PATH], path[MAX_PATH];
+        if (!GetTempPathA(MAX_PATH, dir) || !GetTempFileNameA(dir, "tsk", 0, path)) return INVALID_HANDLE_VALUE;
+        SECURITY_ATTRIBUTES sa = { sizeof(sa), NULL, TRUE };
+        return CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, &sa,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+    }
+
+    // ӽ븸̹ļָ, ֮ǰصͷ
+    static void LogStream(HANDLE f, const string& prefix) {
+        if (f == INVALID_HANDLE_VALUE) return;
+        SetFilePointer(f, 0, NULL, FILE_BEGIN);
+        string text(MAX_CAPTURE, '\0');
+        DWORD got = 0, total = 0;
+        while (total < MAX_CAPTURE && ReadFile(f, &text[total], MAX_CAPTURE - total, &got, NULL) && got > 0) total += got;
+        text.resize(total);
+        LogProcessOutput(text, total == MAX_CAPTURE, prefix);
+    }
+
+    static void CALLBACK OnExit(PVOID ctx, BOOLEAN timedOut) {
+        unique_ptr<Run> r((Run*)ctx);
+        { lock_guard<mutex> lk(r->m); }
+        UnregisterWait(r->wait);    // صڵֻǼע, 
+
+        if (timedOut) {
+            TerminateProcess(r->process, 1);
+            WaitForSingleObject(r->process, 5000);
+        }
+        DWORD code = 0;
+        GetExitCodeProcess(r->process, &code);
+        LogStream(r->out, "G: [" + r->label + "] ");
+        LogStream(r->err, "G: [" + r->label + "] stderr: ");
+
+        if (timedOut) r->done(true, "timed out after " + to_string(r->timeoutMs) + " ms");
+        else if (code != 0) r->done(true, "exit code " + to_string(code));
+        else {
+            Log("G: [" + r->label + "] exited with code 0.");
+            r->done(false, string());
+        }
+    }
+
+public:
+    TaskProcess(string name, string cmd, uint32_t timeout = 60000)
+        : label(move(name)), commandLine(move(cmd)), timeoutMs(timeout) {}
+
+    string GetName() const override { return "Task G: " + label; }
+
+    // ͬʱӽ̽
+    void Execute() override {
+        promise<string> result;
+        Start([&](bool failed, const string& error) { result.set_value(failed ? error : string()); });
+        string error = result.get_future().get();
+        if (!error.empty()) throw runtime_error(error);
+    }
+
+    void Start(TaskDone done) override {
+        auto r = make_unique<Run>();
+        r->label = label;
+        r->timeoutMs = timeoutMs;
+        r->done = move(done);
+        r->out = TempFile();
+        r->err = TempFile();
+        if (r->out == INVALID_HANDLE_VALUE || r->err == INVALID_HANDLE_VALUE) {
+            r->done(true, "cannot create capture files");
+            return;
+        }
+
+        // ļɼ̳, ӽ̵ĲļҲ; þбѼ̳зΧΪԼ,
+        // ÿӽ̶ֵļ, ļҪг˳Żɾ
+        SIZE_T attrSize = 0;
+        InitializeProcThreadAttributeList(NULL, 1, 0, &attrSize);
+        vector<char> attrBuf(attrSize);
+        auto attrs = (LPPROC_THREAD_ATTRIBUTE_LIST)attrBuf.data();
+        HANDLE inherit[2] = { r->out, r->err };
+        if (!InitializeProcThreadAttributeList(attrs, 1, 0, &attrSize)) {
+            r->done(true, "InitializeProcThreadAttributeList failed, error " + to_string(GetLastError()));
+            return;
+        }
+        STARTUPINFOEXA si = {};
+        si.StartupInfo.cb = sizeof(si);
+        si.StartupInfo.dwFlags = STARTF_USESTDHANDLES;
+        si.StartupInfo.hStdInput = NULL;
+        si.StartupInfo.hStdOutput = r->out;
+        si.StartupInfo.hStdError = r->err;
+        si.lpAttributeList = attrs;
+        PROCESS_INFORMATION pi = {};
+        vector<char> cmd(commandLine.begin(), commandLine.end());
+        cmd.push_back('\0');
+        BOOL created = UpdateProcThreadAttribute(attrs, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST, inherit, sizeof(inherit), NULL, NULL)
+            && CreateProcessA(NULL, cmd.data(), NULL, NULL, TRUE, CREATE_NO_WINDOW | EXTENDED_STARTUPINFO_PRESENT, NULL, NULL, &si.StartupInfo, &pi);
+        DWORD error = created ? 0 : GetLastError();
+        DeleteProcThreadAttributeList(attrs);
+        if (!created) {
+            r->done(true, "CreateProcess failed, error " + to_string(error));
+            return;
+        }
+        CloseHandle(pi.hThread);
+        r->process = pi.hProcess;
+        Log("G: [" + label + "] started, pid " + to_string(pi.dwProcessId) + ".");
+
+        Run* raw = r.get();
+        lock_guard<mutex> lk(raw->m);
+        if (!RegisterWaitForSingleObject(&raw->wait, raw->process, OnExit, raw, timeoutMs, WT_EXECUTEONLYONCE)) {
+            TerminateProcess(raw->process, 1);
+            raw->done(true, "RegisterWaitForSingleObject failed, error " + to_string(GetLastError()));
+            return;
+        }
+        r.release();    //  OnExit ӹ
+    }
+};
+#else
+// POSIX: posix_spawn  /bin/sh -c ӽ (Գɽ), stdout / stderr ض unlink ʱļ.
+// ļ O_CLOEXEC , ֻ dup2 뱾ӽ, ֵ̲̳ܽ.
+// ӽ ProcessReaper һ̵߳ȴ, ӽڼ䲻ռõ worker.
+class ProcessReaper {
+    using Clock = chrono::steady_clock;
+    struct Child {
+        pid_t pid;
+        int pidfd;      // -1: û pidfd, ѯ
+        Clock::time_point deadline;
+        function<void(int status, bool timedOut)> done;
+    };
+
+    static constexpr int POLL_FALLBACK_MS = 50;
+
+    mutex m;
+    vector<Child> incoming;
+    int wakeR = -1, wakeW = -1;
+    bool running = false;
+    thread loop;
+
+    // Linux 5.3+  pidfd ӽ˳ʱΪɶ; ں˻ϵͳ -1,  Loop ÿ 50 ms  waitpid(WNOHANG) ѯ
+    static int PidFd(pid_t pid) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+        return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+        (void)pid;
+        return -1;
+#endif
+    }
+
+    void Loop() {
+        vector<Child> children;
+        vector<pollfd> fds;
+        vector<size_t> polled;
+        vector<char> ready;
+        for (;;) {
+            {
+                lock_guard<mutex> lk(m);
+                if (!running) break;
+                for (auto& c : incoming) children.push_back(move(c));
+                incoming.clear();
+            }
+            auto now = Clock::now();
+            auto next = now + chrono::seconds(1);
+            fds.clear();
+            polled.clear();
+            fds.push_back({ wakeR, POLLIN, 0 });
+            for (size_t i = 0; i < children.size(); ++i) {
+                next = min(next, children[i].deadline);
+                if (children[i].pidfd < 0) next = min(next, now + chrono::milliseconds(POLL_FALLBACK_MS));
+                else { fds.push_back({ children[i].pidfd, POLLIN, 0 }); polled.push_back(i); }
+            }
+            poll(fds.data(), (nfds_t)fds.size(), (int)max<long long>(0, chrono::duration_cast<chrono::milliseconds>(next - now).count() + 1));
+            if (fds[0].revents & POLLIN) {
+                char drain[64];
+                while (read(wakeR, drain, sizeof(drain)) > 0) {}
+            }
+
+            // ֻ pidfd ɶû pidfd ѵڵӽ̵ waitpid
+            now = Clock::now();
+            ready.assign(children.size(), 0);
+            for (size_t k = 0; k < polled.size(); ++k) ready[polled[k]] = fds[k + 1].revents != 0;
+            for (size_t i = children.size(); i-- > 0;) {
+                Child& c = children[i];
+                if (!ready[i] && c.pidfd >= 0 && now < c.deadline) continue;
+                int status = 0;
+                bool timedOut = false;
+                pid_t r = waitpid(c.pid, &status, WNOHANG);
+                if (r == 0 && now >= c.deadline) {
+                    kill(-c.pid, SIGKILL);      // ,  sh Ľ
+                    r = waitpid(c.pid, &status, 0);
+                    timedOut = true;
+                }
+                if (r == 0) continue;
+                if (c.pidfd >= 0) close(c.pidfd);
+                auto done = move(c.done);
+                children[i] = move(children.back());
+                children.pop_back();
+                done(r < 0 ? -1 : status, timedOut);
+            }
+        }
+
+        // ˳ʱɱеӽ̲, ٻص
+        for (auto& c : children) {
+            kill(-c.pid, SIGKILL);
+            waitpid(c.pid, nullptr, 0);
+            if (c.pidfd >= 0) close(c.pidfd);
+        }
+    }
+
+    ProcessReaper() {
+        int p[2];
+        if (pipe(p) != 0) throw runtime_error("ProcessReaper: pipe failed");
+        for (int fd : p) {
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        }
+        wakeR = p[0];
+        wakeW = p[1];
+    }
+
+public:
+    static ProcessReaper& Instance() { static ProcessReaper r; return r; }
+
+    ~ProcessReaper() {
+        {
+            lock_guard<mutex> lk(m);
+            running = false;
+        }
+        char b = 1;
+        if (write(wakeW, &b, 1) < 0) {}
+        if (loop.joinable()) loop.join();
+        for (auto& c : incoming) {
+            kill(-c.pid, SIGKILL);
+            waitpid(c.pid, nullptr, 0);
+            if (c.pidfd >= 0) close(c.pidfd);
+        }
+        close(wakeR);
+        close(wakeW);
+    }
+
+    // ӽ˳ʱ ( SIGKILL ) ڵȴ߳ϵ done; status Ϊ waitpid Ľ, ʧʱΪ -1
+    void Add(pid_t pid, uint32_t timeoutMs, function<void(int status, bool timedOut)> done) {
+        Child c{ pid, PidFd(pid), Clock::now() + chrono::milliseconds(timeoutMs), move(done) };
+        {
+            lock_guard<mutex> lk(m);
+            if (!loop.joinable()) {
+                running = true;
+                loop = thread(&ProcessReaper::Loop, this);
+            }
+            incoming.push_back(move(c));
+        }
+        char b = 1;
+        if (write(wakeW, &b, 1) < 0) {}   // ܵ˵δĻ
+    }
+};
+
+class TaskProcess : public ITask {
+    static constexpr size_t MAX_CAPTURE = 64 * 1024;    // ÿ¼ֽ
+
+    string label;
+    string commandLine;
+    uint32_t timeoutMs;
+
+    static int TempFile() {
+        string path = (fs::temp_directory_path() / "tskXXXXXX").string();
+        int fd = mkostemp(path.data(), O_CLOEXEC);
+        if (fd >= 0) unlink(path.c_str());
+        return fd;
+    }
+
+    static void LogStream(int fd, const string& prefix) {
+        string text(MAX_CAPTURE, '\0');
+        size_t total = 0;
+        for (ssize_t got; total < MAX_CAPTURE && (got = pread(fd, &text[total], MAX_CAPTURE - total, (off_t)total)) > 0;) total += (size_t)got;
+        text.resize(total);
+        LogProcessOutput(text, total == MAX_CAPTURE, prefix);
+    }
+
+public:
+    TaskProcess(string name, string cmd, uint32_t timeout = 60000)
+        : label(move(name)), commandLine(move(cmd)), timeoutMs(timeout) {}
+
+    string GetName() const override { return "Task G: " + label; }
+
+    // ͬʱӽ̽
+    void Execute() override {
+        promise<string> result;
+        Start([&](bool failed, const string& error) { result.set_value(failed ? error : string()); });
+        string error = result.get_future().get();
+        if (!error.empty()) throw runtime_error(error);
+    }
+
+    void Start(TaskDone done) override {
+        ProcessReaper& reaper = ProcessReaper::Instance();
+        int out = TempFile(), err = TempFile();
+        if (out < 0 || err < 0) {
+            if (out >= 0) close(out);
+            if (err >= 0) close(err);
+            done(true, "cannot create capture files");
+            return;
+        }
+
+        posix_spawn_file_actions_t fa;
+        posix_spawn_file_actions_init(&fa);
+        posix_spawn_file_actions_addopen(&fa, 0, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_adddup2(&fa, out, 1);
+        posix_spawn_file_actions_adddup2(&fa, err, 2);
+        posix_spawnattr_t attr;
+        posix_spawnattr_init(&attr);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+        posix_spawnattr_setpgroup(&attr, 0);
+        const char* argv[] = { "sh", "-c", commandLine.c_str(), nullptr };
+        pid_t pid = 0;
+        int rc = posix_spawn(&pid, "/bin/sh", &fa, &attr, (char* const*)argv, environ);
+        posix_spawnattr_destroy(&attr);
+        posix_spawn_file_actions_destroy(&fa);
+        if (rc != 0) {
+            close(out);
+            close(err);
+            done(true, "posix_spawn failed: " + string(strerror(rc)));
+            return;
+        }
+        Log("G: [" + label + "] started, pid " + to_string(pid) + ".");
+
+        reaper.Add(pid, timeoutMs, [out, err, label = label, timeout = timeoutMs, done = move(done)](int status, bool timedOut) {
+            LogStream(out, "G: [" + label + "] ");
+            LogStream(err, "G: [" + label + "] stderr: ");
+            close(out);
+            close(err);
+            if (timedOut) done(true, "timed out after " + to_string(timeout) + " ms");
+            else if (status < 0) done(true, "waitpid failed");
+            else if (WIFSIGNALED(status)) done(true, "killed by signal " + to_string(WTERMSIG(status)));
+            else if (WEXITSTATUS(status) != 0) done(true, "exit code " + to_string(WEXITSTATUS(status)));
+            else {
+                Log("G: [" + label + "] exited with code 0.");
+                done(false, string());
+            }
+        });
+    }
+};
+#endif
+
+// ==========================================
+// ʽͳ (Task E)
+// ==========================================
+// ʽͳ, O(1) ڴ: ÿȷ / ƽ, õֵ M2,
+// ٰ Chan йʽнϲ (Welford ķֿʽ); ͬʱά min / max  0..100 ֱͼ.
+class StreamingStats {
+public:
+    static constexpr int HIST_BINS = 101;
+    static constexpr size_t BLOCK = 4096; // , ֤ 32 λͨڵĺ / ƽͲ
+
+private:
+    uint64_t n = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    int minV = INT_MAX;
+    int maxV = INT_MIN;
+    uint64_t hist[HIST_BINS] = {};
+
+    void MergeMoments(uint64_t bn, double bmean, double bm2) {
+        if (bn == 0) return;
+        uint64_t total = n + bn;
+        double delta = bmean - mean;
+        mean += delta * (double)bn / (double)total;
+        m2 += bm2 + delta * delta * (double)n * (double)bn / (double)total;
+        n = total;
+    }
+
+    //  BLOCK ȡֵ 0..100 
+    void AddChunk(const int* data, size_t count) {
+        int64_t sum = 0, sumSq = 0;
+        int lo = INT_MAX, hi = INT_MIN;
+        size_t i = 0;
+#if defined(__AVX2__)
+        __m256i vSum = _mm256_setzero_si256(), vSq = _mm256_setzero_si256();
+        __m256i vMin = _mm256_set1_epi32(INT_MAX), vMax = _mm256_set1_epi32(INT_MIN);
+        for (; i + 8 <= count; i += 8) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(data + i));
+            vSum = _mm256_add_epi32(vSum, x);
+            vSq = _mm256_add_epi32(vSq, _mm256_mullo_epi32(x, x));
+            vMin = _mm256_min_epi32(vMin, x);
+            vMax = _mm256_max_epi32(vMax, x);
+        }
+        alignas(32) int32_t lane[4][8];
+        _mm256_store_si256((__m256i*)lane[0], vSum);
+        _mm256_store_si256((__m256i*)lane[1], vSq);
+        _mm256_store_si256((__m256i*)lane[2], vMin);
+        _mm256_store_si256((__m256i*)lane[3], vMax);
+        for (int k = 0; k < 8; ++k) {
+            sum += lane[0][k];
+            sumSq += lane[1][k];
+            lo = min(lo, lane[2][k]);
+            hi = max(hi, lane[3][k]);
+        }
+#endif
+        for (; i < count; ++i) {
+            int x = data[i];
+            sum += x;
+            sumSq += (int64_t)x * x;
+            lo = min(lo, x);
+            hi = max(hi, x);
+        }
+
+        // 4 ֱͼۼ, ͬһͰʱд
+        uint32_t sub[4][HIST_BINS] = {};
+        i = 0;
+        for (; i + 4 <= count; i += 4) {
+            ++sub[0][data[i]];
+            ++sub[1][data[i + 1]];
+            ++sub[2][data[i + 2]];
+            ++sub[3][data[i + 3]];
+        }
+        for (; i < count; ++i) ++sub[0][data[i]];
+        for (int b = 0; b < HIST_BINS; ++b) hist[b] += (uint64_t)sub[0][b] + sub[1][b] + sub[2][b] + sub[3][b];
+
+        minV = min(minV, lo);
+        maxV = max(maxV, hi);
+        double bmean = (double)sum / (double)count;
+        double bm2 = (double)((int64_t)count * sumSq - sum * sum) / (double)count; // ȷ, ٳһ
+        MergeMoments(count, bmean, bm2);
+    }
+
+public:
+    //  0..100 ֮ (Χֵضϵ)
+    void AddBlock(const int* data, size_t count) {
+        int clipped[BLOCK];
+        while (count > 0) {
+            size_t c = min(count, BLOCK);
+            bool inRange = true;
+            for (size_t i = 0; i < c; ++i) inRange &= (data[i] >= 0 && data[i] < HIST_BINS);
+            if (inRange) {
+                AddChunk(data, c);
+            }
+            else {
+                for (size_t i = 0; i < c; ++i) clipped[i] = min(max(data[i], 0), HIST_BINS - 1);
+                AddChunk(clipped, c);
+            }
+            data += c;
+            count -= c;
+        }
+    }
+
+    void Merge(const StreamingStats& o) {
+        MergeMoments(o.n, o.mean, o.m2);
+        minV = min(minV, o.minV);
+        maxV = max(maxV, o.maxV);
+        for (int b = 0; b < HIST_BINS; ++b) hist[b] += o.hist[b];
+    }
+
+    uint64_t Count() const { return n; }
+    double Mean() const { return mean; }
+    double Variance() const { return n ? m2 / (double)n : 0.0; } // 巽, ԭһ
+    int Min() const { return minV; }
+    int Max() const { return maxV; }
+    uint64_t Bin(int v) const { return hist[v]; }
+};
+
+// --- Task E: Stats ---
+class TaskStats : public ITask {
+    uint64_t sampleCount; // <= 1000 ʱݴϻȫ, ʽͳ
+    int runCount = 0;
+public:
+    explicit TaskStats(uint64_t sampleCount = 1000) : sampleCount(max<uint64_t>(1, sampleCount)) {}
+    string GetName() const override {
+        return sampleCount <= 1000 ? "Task E: Random Stats" : "Task E: Random Stats (stream " + to_string(sampleCount) + ")";
+    }
+    void Execute() override {
+        if (sampleCount > 1000) { ExecuteStreaming(); return; }
+
+        Log("E: Generating " + to_string(sampleCount) + " numbers...");
+
+        int nums[1000];
+        size_t count = (size_t)sampleCount;
+        RandomService::Acquire(RandomService::StreamKey('E', (uint32_t)runCount++)).FillInt(nums, count, 0, 100);
+
+        LogData(FormatTable(nums, count));
+        Log("E: Stats computed (See Data Board).");
+    }
+
+    // ݴ: ÿ 20 ıͳժҪ. ڵǰ̵߳ ReportBuffer , ´ Begin ǰЧ
+    static const string& FormatTable(const int* nums, size_t count) {
+        ReportBuffer& rb = ReportBuffer::Begin();
+        rb.Banner(84, [&](ReportBuffer& r) {
+            r.Text(" TASK E: DATA MATRIX (20 Columns x ").UInt((count + 19) / 20).Text(" Rows)");
+        });
+        rb.Text("+").Repeat('-', 82).Text("+").NewLine();
+        for (size_t i = 0; i < count; ++i) {
+            if (i % 20 == 0) rb.Text("| ");
+            rb.Int(nums[i], 3).Text(" ");
+            if ((i + 1) % 20 == 0) rb.Text(" |").NewLine();
+        }
+        if (count % 20) rb.Repeat(' ', (20 - count % 20) * 4).Text(" |").NewLine();
+        rb.Text("+").Repeat('-', 82).Text("+").NewLine();
+
+        StreamingStats stats;
+        stats.AddBlock(nums, count);
+
+        rb.Text("  [STATISTICS REPORT]").NewLine();
+        rb.Field("Count:    ").UInt(stats.Count()).NewLine();
+        rb.Field("Mean:     ").Fixed(stats.Mean(), 2).NewLine();
+        rb.Field("Variance: ").Fixed(stats.Variance(), 2).NewLine();
+        return rb.Str();
+    }
+
+    // ɲۼ, 
+    void ExecuteStreaming() {
+        Log("E: Streaming " + to_string(sampleCount) + " samples...");
+
+        FastRng& rng = RandomService::Acquire(RandomService::StreamKey('E', (uint32_t)runCount++));
+        StreamingStats stats;
+        int block[StreamingStats::BLOCK];
+
+        auto start = chrono::high_resolution_clock::now();
+        for (uint64_t done = 0; done < sampleCount;) {
+            size_t c = (size_t)min<uint64_t>(StreamingStats::BLOCK, sampleCount - done);
+            rng.FillInt(block, c, 0, 100);
+            stats.AddBlock(block, c);
+            done += c;
+        }
+        chrono::duration<double> elapsed = chrono::high_resolution_clock::now() - start;
+        double rate = (double)sampleCount / max(elapsed.count(), 1e-9);
+
+        ReportBuffer& rb = ReportBuffer::Begin();
+        rb.Banner(84, [&](ReportBuffer& r) {
+            r.Text(" TASK E: STREAMING STATS (").UInt(sampleCount).Text(" samples)");
+        });
+        rb.Text("  [STATISTICS REPORT]").NewLine();
+        rb.Field("Count:      ").UInt(stats.Count()).NewLine();
+        rb.Field("Mean:       ").Fixed(stats.Mean(), 4).NewLine();
+        rb.Field("Variance:   ").Fixed(stats.Variance(), 4).NewLine();
+        rb.Field("Min / Max:  ").Int(stats.Min()).Text(" / ").Int(stats.Max()).NewLine();
+        rb.Field("Throughput: ").Fixed(rate / 1e6, 2).Text(" M samples/s").NewLine();
+        rb.Text("  [HISTOGRAM]").NewLine();
+        for (int b = 0; b < 10; ++b) {
+            uint64_t cnt = 0;
+            int hiV = (b == 9) ? 100 : b * 10 + 9;
+            for (int v = b * 10; v <= hiV; ++v) cnt += stats.Bin(v);
+            double pct = 100.0 * (double)cnt / (double)stats.Count();
+            rb.Text("  ").Int(b * 10, 3).Text("-").Int(hiV, 3).Text(" |").Repeat('#', (size_t)(pct * 0.6 + 0.5))
+                .Text(" ").Fixed(pct, 2).Text("%").NewLine();
+        }
+        LogData(rb.Str());
+
+        ReportBuffer& msg = ReportBuffer::Begin();
+        msg.Text("E: Streamed ").UInt(sampleCount).Text(" samples in ").Fixed(elapsed.count() * 1000.0, 2)
+            .Text(" ms (").Fixed(rate / 1e6, 2).Text(" M samples/s).");
+        Log(msg.Str());
+    }
+};
+
+// --- Task F: Chaos ---
+class TaskChaos : public ITask {
+public:
+    string GetName() const override { return "Task F: CHAOS (FREEZE)"; }
+    void Execute() override {
+        Log("F: Critical Error! Throwing Exception...");
+        throw runtime_error("CORE DUMP: MEMORY VIOLATION");
+    }
+};
+
+// ==========================================
+// 
+// ==========================================
+// ڲһʹõʱ, ޸ϵͳʱ䲻ǰƳ; ֻʾͳ־ûʱΪǽʱ
+using SchedClock = chrono::steady_clock;
+
+// FixedDelay: ϴнٵ interval (ʱƯ);
+// FixedRate: ê״μƻʱ,  k мƻ anchor + k * interval
+enum class PeriodMode { FixedDelay, FixedRate };
+
+// : FireOnce ϲΪһ; FireAll  (, Ķ);
+// Skip һδ (һֱӶ). ڹʱ FixedRate , ԼͣĻָ
+enum class MissedRunPolicy { FireOnce, FireAll, Skip };
+
+// ڶ: ļȥ interval (), Welford ߾ֵ / 
+struct JitterStats {
+    uint64_t n = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double maxAbs = 0.0;
+
+    void Add(double ms) {
+        ++n;
+        double d = ms - mean;
+        mean += d / (double)n;
+        m2 += d * (ms - mean);
+        maxAbs = max(maxAbs, fabs(ms));
+    }
+
+    double StdDev() const { return n > 1 ? sqrt(m2 / (double)n) : 0.0; }
+};
+
+// ȼ, ֵԽСԽ
+enum class TaskPriority { Critical, High, Normal, Low };
+static constexpr int PRIORITY_CLASSES = 4;
+
+// AddTask 
+struct TaskSpec {
+    shared_ptr<ITask> task;
+    int delayMs = 0;
+    int intervalMs = 0;  // > 0 Ϊ
+    int kind = 0;        // TaskFactory , ڳ־ûؽ; 0 ʾ־û
+    PeriodMode mode = PeriodMode::FixedDelay;
+    MissedRunPolicy overrun = MissedRunPolicy::FireOnce; //  FixedRate
+    int maxCatchUp = 10;                                 // overrun Ϊ FireAll ʱܵ
+    TaskPriority priority = TaskPriority::Normal;
+    int deadlineMs = 0;  // ÿμƻʱ̵, 0 ʾû
+};
+
+struct ScheduledTask {
+    int id = 0;
+    shared_ptr<ITask> task = nullptr;
+    SchedClock::time_point runTime = {};
+    bool isPeriodic = false;
+    chrono::milliseconds interval = chrono::milliseconds(0);
+    int failures = 0; // ʧܴ, ɹһμ
+    int kind = 0;     // TaskFactory , ڳ־ûؽ; 0 ʾ־û
+    int catchUp = 0;  // FixedDelay ָܵĴ (MissedRunPolicy::FireAll)
+    PeriodMode mode = PeriodMode::FixedDelay;
+    MissedRunPolicy overrun = MissedRunPolicy::FireOnce;
+    int maxCatchUp = 10;
+    SchedClock::time_point nominal = {};   // FixedRate: жӦļƻʱ;  / ۶Ƴֻ runTime
+    SchedClock::time_point lastStart = {}; // ϴʱ, ڶͳ
+    JitterStats jitter;
+    TaskPriority priority = TaskPriority::Normal;
+    chrono::milliseconds relDeadline = chrono::milliseconds(0);
+    SchedClock::time_point deadline = SchedClock::time_point::max(); // еĽֹʱ, ʱ
+    size_t heapIndex = SIZE_MAX; //  TaskHeap еĲλ, ɶά
+
+    // TimingWheel õʽ˫, ʱά
+    ScheduledTask* wheelPrev = nullptr;
+    ScheduledTask* wheelNext = nullptr;
+    int wheelSlot = -1;
+
+    static string TimeStr(SchedClock::time_point tp) {
+        auto wall = chrono::system_clock::now() + chrono::duration_cast<chrono::system_clock::duration>(tp - SchedClock::now());
+        auto t = chrono::system_clock::to_time_t(wall);
+        struct tm tmInfo; localtime_s(&tmInfo, &t);
+        stringstream ss; ss << put_time(&tmInfo, "%H:%M:%S");
+        return ss.str();
+    }
+
+    string GetTimeStr() { return TimeStr(runTime); }
+};
+
+// ʱ洢ӿ: ͨȡ, ڶʱ֮л
+class ITimerStore {
+public:
+    virtual bool Empty() const = 0;
+    virtual size_t Size() const = 0;
+    virtual void Push(shared_ptr<ScheduledTask> st) = 0;
+    // , Ĭ Push
+    virtual void PushAll(const vector<shared_ptr<ScheduledTask>>& batch) { for (const auto& st : batch) Push(st); }
+    // ȡһ runTime <= now , û򷵻 nullptr
+    virtual shared_ptr<ScheduledTask> PopDue(SchedClock::time_point now) = 0;
+    // һҪ鵽ڵʱ (ڷǿʱ)
+    virtual SchedClock::time_point NextWakeup() const = 0;
+    // ʱ nullptr
+    virtual shared_ptr<ScheduledTask> Remove(int id) = 0;
+    virtual shared_ptr<ScheduledTask> Find(int id) const = 0;
+    virtual void Clear() = 0;
+    virtual void ForEach(const function<void(const shared_ptr<ScheduledTask>&)>& f) const = 0;
+    virtual string GetName() const = 0;
+    virtual ~ITimerStore() = default;
+};
+
+//  d С:  runTime , λд ScheduledTask::heapIndex,
+//  id ->  ,  / ȡ /  id Ϊ O(log n).
+// λ (runTime, id), ϸ / ³ֻȽŵĲλ, ;  byId .
+class TaskHeap : public ITimerStore {
+    static const size_t D = 4;
+
+    struct Slot {
+        SchedClock::rep time;
+        int id;
+        ScheduledTask* st;
+        bool operator<(const Slot& o) const { return time != o.time ? time < o.time : id < o.id; }
+    };
+
+    vector<Slot> heap;
+    unordered_map<int, shared_ptr<ScheduledTask>> byId;
+
+    static Slot MakeSlot(ScheduledTask* st) { return { st->runTime.time_since_epoch().count(), st->id, st }; }
+
+    void Place(size_t i, const Slot& s) {
+        s.st->heapIndex = i;
+        heap[i] = s;
+    }
+
+    void SiftUp(size_t i) {
+        Slot s = heap[i];
+        while (i > 0) {
+            size_t parent = (i - 1) / D;
+            if (!(s < heap[parent])) break;
+            Place(i, heap[parent]);
+            i = parent;
+        }
+        Place(i, s);
+    }
+
+    void SiftDown(size_t i) {
+        Slot s = heap[i];
+        size_t n = heap.size();
+        while (true) {
+            size_t first = i * D + 1;
+            if (first >= n) break;
+            size_t last = min(first + D, n);
+            size_t best = first;
+            for (size_t c = first + 1; c < last; ++c)
+                if (heap[c] < heap[best]) best = c;
+            if (!(heap[best] < s)) break;
+            Place(i, heap[best]);
+            i = best;
+        }
+        Place(i, s);
+    }
+
+    shared_ptr<ScheduledTask> RemoveAt(size_t i) {
+        ScheduledTask* removed = heap[i].st;
+        Slot tail = heap.back();
+        heap.pop_back();
+        if (i < heap.size()) {
+            Place(i, tail);
+            if (i > 0 && heap[i] < heap[(i - 1) / D]) SiftUp(i);
+            else SiftDown(i);
+        }
+        removed->heapIndex = SIZE_MAX;
+        auto node = byId.extract(removed->id);
+        return move(node.mapped());
+    }
+
+public:
+    bool Empty() const override { return heap.empty(); }
+    size_t Size() const override { return heap.size(); }
+
+    void Push(shared_ptr<ScheduledTask> st) override {
+        ScheduledTask* p = st.get();
+        byId[p->id] = move(st);
+        heap.push_back(MakeSlot(p));
+        SiftUp(heap.size() - 1);
+    }
+
+    // βСжʱؽ (ԵϽ, O(n)), ϸ
+    void PushAll(const vector<shared_ptr<ScheduledTask>>& batch) override {
+        if (batch.empty()) return;
+        if (batch.size() < heap.size()) { for (const auto& st : batch) Push(st); return; }
+        byId.reserve(byId.size() + batch.size());
+        heap.reserve(heap.size() + batch.size());
+        for (const auto& st : batch) {
+            byId[st->id] = st;
+            heap.push_back(MakeSlot(st.get()));
+        }
+        for (size_t i = 0; i < heap.size(); ++i) heap[i].st->heapIndex = i;
+        for (size_t i = heap.size() / D + 1; i-- > 0;) SiftDown(i);
+    }
+
+    shared_ptr<ScheduledTask> Pop() { return RemoveAt(0); }
+
+    shared_ptr<ScheduledTask> PopDue(SchedClock::time_point now) override {
+        if (heap.empty() || heap.front().time > now.time_since_epoch().count()) return nullptr;
+        return Pop();
+    }
+
+    SchedClock::time_point NextWakeup() const override { return SchedClock::time_point(SchedClock::duration(heap.front().time)); }
+
+    shared_ptr<ScheduledTask> Remove(int id) override {
+        auto it = byId.find(id);
+        if (it == byId.end()) return nullptr;
+        return RemoveAt(it->second->heapIndex);
+    }
+
+    shared_ptr<ScheduledTask> Find(int id) const override {
+        auto it = byId.find(id);
+        return it == byId.end() ? nullptr : it->second;
+    }
+
+    void Clear() override {
+        for (auto& s : heap) s.st->heapIndex = SIZE_MAX;
+        heap.clear();
+        byId.clear();
+    }
+
+    // ˳ (ʱ˳)
+    void ForEach(const function<void(const shared_ptr<ScheduledTask>&)>& f) const override {
+        for (const auto& kv : byId) f(kv.second);
+    }
+
+    string GetName() const override { return "4-ary Heap"; }
+};
+
+// ֲʱ: 6  x 64 , ÿʽ FIFO ,  /  O(1).
+// ʱȡ tick, һ tick , ǰ.
+// ƽʱÿռλͼֱһǿղ, ת tick ǰ.
+class TimingWheel : public ITimerStore {
+    static const int BITS = 6;
+    static const int SLOTS = 1 << BITS;
+    static const int LEVELS = 6;
+    static const int DUE_SLOT = LEVELS * SLOTS; // ѵ, ȴ PopDue
+
+    struct Bucket {
+        ScheduledTask* head = nullptr;
+        ScheduledTask* tail = nullptr;
+    };
+
+    SchedClock::time_point origin;
+    chrono::nanoseconds tick;
+    uint64_t curTick = 0;
+    Bucket buckets[DUE_SLOT + 1];
+    uint64_t occupied[LEVELS] = {};
+    unordered_map<int, shared_ptr<ScheduledTask>> byId;
+
+    uint64_t ExpiryTick(SchedClock::time_point t) const {
+        if (t <= origin) return 0;
+        auto ns = chrono::duration_cast<chrono::nanoseconds>(t - origin).count();
+        return (uint64_t)((ns + tick.count() - 1) / tick.count());
+    }
+
+    void Link(ScheduledTask* st, int slot) {
+        Bucket& b = buckets[slot];
+        st->wheelSlot = slot;
+        st->wheelNext = nullptr;
+        st->wheelPrev = b.tail;
+        if (b.tail) b.tail->wheelNext = st; else b.head = st;
+        b.tail = st;
+        if (slot < DUE_SLOT) occupied[slot / SLOTS] |= 1ULL << (slot % SLOTS);
+    }
+
+    void Unlink(ScheduledTask* st) {
+        int slot = st->wheelSlot;
+        Bucket& b = buckets[slot];
+        if (st->wheelPrev) st->wheelPrev->wheelNext = st->wheelNext; else b.head = st->wheelNext;
+        if (st->wheelNext) st->wheelNext->wheelPrev = st->wheelPrev; else b.tail = st->wheelPrev;
+        st->wheelPrev = st->wheelNext = nullptr;
+        st->wheelSlot = -1;
+        if (slot < DUE_SLOT && !b.head) occupied[slot / SLOTS] &= ~(1ULL << (slot % SLOTS));
+    }
+
+    //  tick 뵱ǰ tick ߲λ㼶 (ͬ Linux ʱ)
+    void Place(ScheduledTask* st) {
+        uint64_t expiry = ExpiryTick(st->runTime);
+        if (expiry <= curTick) { Link(st, DUE_SLOT); return; }
+        // 㴰: ȹڴĩβ, ʱʵ runTime ·
+        uint64_t windowEnd = ((curTick >> (BITS * LEVELS)) << (BITS * LEVELS)) + ((1ULL << (BITS * LEVELS)) - 1);
+        if (expiry > windowEnd) expiry = max(windowEnd, curTick + 1);
+        int level = 0;
+        while (level < LEVELS - 1 && (expiry >> (BITS * (level + 1))) != (curTick >> (BITS * (level + 1)))) ++level;
+        int idx = (int)((expiry >> (BITS * level)) & (SLOTS - 1));
+        Link(st, level * SLOTS + idx);
+    }
+
+    // һҪ tick; ǿղ۵һڸò㵱ǰ
+    bool NextEventTick(uint64_t& out) const {
+        bool found = false;
+        for (int level = 0; level < LEVELS; ++level) {
+            if (!occupied[level]) continue;
+            int cur = (int)((curTick >> (BITS * level)) & (SLOTS - 1));
+            uint64_t ahead = (cur == SLOTS - 1) ? 0 : occupied[level] & (~0ULL << (cur + 1));
+            if (!ahead) continue;
+            int idx = 0;
+            while (!(ahead & (1ULL << idx))) ++idx;
+            int shift = BITS * (level + 1);
+            uint64_t base = (shift >= 64) ? 0 : (curTick >> shift) << shift;
+            uint64_t t = base + ((uint64_t)idx << (BITS * level));
+            if (!found || t < out) { out = t; found = true; }
+        }
+        return found;
+    }
+
+    void Advance(uint64_t target) {
+        uint64_t next = 0;
+        while (NextEventTick(next) && next <= target) {
+            curTick = next;
+            // Ը߲Ͳ㼶: ֻеλȫΪ 0 Ĳֵ
+            int top = 0;
+            while (top < LEVELS - 1 && ((curTick >> (BITS * (top + 1))) << (BITS * (top + 1))) == curTick) ++top;
+            for (int level = top; level >= 0; --level) {
+                int slot = level * SLOTS + (int)((curTick >> (BITS * level)) & (SLOTS - 1));
+                ScheduledTask* st = buckets[slot].head;
+                while (st) {
+                    ScheduledTask* nxt = st->wheelNext;
+                    Unlink(st);
+                    Place(st);
+                    st = nxt;
+                }
+            }
+        }
+        if (target > curTick) curTick = target;
+    }
+
+public:
+    explicit TimingWheel(chrono::milliseconds tickRes = chrono::milliseconds(1))
+        : origin(SchedClock::now()), tick(max<chrono::nanoseconds>(tickRes, chrono::milliseconds(1))) {}
+    ~TimingWheel() { Clear(); }
+
+    bool Empty() const override { return byId.empty(); }
+    size_t Size() const override { return byId.size(); }
+
+    void Push(shared_ptr<ScheduledTask> st) override {
+        Place(st.get());
+        byId[st->id] = move(st);
+    }
+
+    shared_ptr<ScheduledTask> PopDue(SchedClock::time_point now) override {
+        if (!buckets[DUE_SLOT].head) {
+            auto ns = now > origin ? chrono::duration_cast<chrono::nanoseconds>(now - origin).count() : 0;
+            Advance((uint64_t)(ns / tick.count()));
+        }
+        ScheduledTask* st = buckets[DUE_SLOT].head;
+        if (!st) return nullptr;
+        Unlink(st);
+        auto it = byId.find(st->id);
+        shared_ptr<ScheduledTask> res = move(it->second);
+        byId.erase(it);
+        return res;
+    }
+
+    SchedClock::time_point NextWakeup() const override {
+        if (buckets[DUE_SLOT].head) return origin + chrono::duration_cast<SchedClock::duration>(tick * curTick);
+        uint64_t next = curTick;
+        NextEventTick(next);
+        return origin + chrono::duration_cast<SchedClock::duration>(tick * next);
+    }
+
+    shared_ptr<ScheduledTask> Remove(int id) override {
+        auto it = byId.find(id);
+        if (it == byId.end()) return nullptr;
+        shared_ptr<ScheduledTask> res = move(it->second);
+        byId.erase(it);
+        Unlink(res.get());
+        return res;
+    }
+
+    shared_ptr<ScheduledTask> Find(int id) const override {
+        auto it = byId.find(id);
+        return it == byId.end() ? nullptr : it->second;
+    }
+
+    void Clear() override {
+        for (auto& kv : byId) {
+            kv.second->wheelPrev = kv.second->wheelNext = nullptr;
+            kv.second->wheelSlot = -1;
+        }
+        for (auto& b : buckets) b = Bucket();
+        for (auto& o : occupied) o = 0;
+        byId.clear();
+    }
+
+    void ForEach(const function<void(const shared_ptr<ScheduledTask>&)>& f) const override {
+        for (const auto& kv : byId) f(kv.second);
+    }
+
+    string GetName() const override {
+        return "Timing Wheel (" + to_string(chrono::duration_cast<chrono::milliseconds>(tick).count()) + " ms tick)";
+    }
+};
+
+// ѵڡȴ worker . ȱȼ, ֹͬʱ (EDF, ޽ֹʱ, ٰȺ);
+// ÿеȵõÿ agingStep Ϊһ, ȼᱻĸȼ
+class ReadyQueue {
+    struct DeadlineKey {
+        SchedClock::time_point deadline;
+        SchedClock::time_point runTime;
+        int id;
+        bool operator<(const DeadlineKey& o) const {
+            if (deadline != o.deadline) return deadline < o.deadline;
+            if (runTime != o.runTime) return runTime < o.runTime;
+            return id < o.id;
+        }
+    };
+
+    struct Lane {
+        set<DeadlineKey> byDeadline;
+        set<pair<SchedClock::time_point, int>> byRunTime; // ȴõǰ
+    };
+
+    array<Lane, PRIORITY_CLASSES> lanes;
+    unordered_map<int, shared_ptr<ScheduledTask>> byId;
+
+    static DeadlineKey KeyOf(const ScheduledTask& st) { return { st.deadline, st.runTime, st.id }; }
+
+    void Erase(const ScheduledTask& st) {
+        Lane& lane = lanes[(int)st.priority];
+        lane.byDeadline.erase(KeyOf(st));
+        lane.byRunTime.erase({ st.runTime, st.id });
+    }
+
+public:
+    bool Empty() const { return byId.empty(); }
+    size_t Size() const { return byId.size(); }
+
+    void Push(shared_ptr<ScheduledTask> st) {
+        // FixedRate ޴Ӽƻʱ, Ƴٲſ
+        auto base = st->isPeriodic && st->mode == PeriodMode::FixedRate ? st->nominal : st->runTime;
+        st->deadline = st->relDeadline.count() > 0 ? base + st->relDeadline : SchedClock::time_point::max();
+        Lane& lane = lanes[(int)st->priority];
+        lane.byDeadline.insert(KeyOf(*st));
+        lane.byRunTime.insert({ st->runTime, st->id });
+        byId[st->id] = move(st);
+    }
+
+    shared_ptr<ScheduledTask> Pop(SchedClock::time_point now, SchedClock::duration agingStep) {
+        int bestClass = INT_MAX;
+        SchedClock::time_point bestDeadline;
+        shared_ptr<ScheduledTask> best;
+        for (int c = 0; c < PRIORITY_CLASSES; ++c) {
+            const Lane& lane = lanes[c];
+            if (lane.byDeadline.empty()) continue;
+            int eff = c;
+            if (agingStep.count() > 0) eff = max(0, c - (int)((now - lane.byRunTime.begin()->first) / agingStep));
+            // ļɵȵõ, ȡֹʱ
+            int id = eff < c ? lane.byRunTime.begin()->second : lane.byDeadline.begin()->id;
+            const auto& st = byId.find(id)->second;
+            if (eff < bestClass || (eff == bestClass && st->deadline < bestDeadline)) {
+                bestClass = eff;
+                bestDeadline = st->deadline;
+                best = st;
+            }
+        }
+        if (best) {
+            Erase(*best);
+            byId.erase(best->id);
+        }
+        return best;
+    }
+
+    shared_ptr<ScheduledTask> Remove(int id) {
+        auto it = byId.find(id);
+        if (it == byId.end()) return nullptr;
+        auto st = move(it->second);
+        byId.erase(it);
+        Erase(*st);
+        return st;
+    }
+
+    shared_ptr<ScheduledTask> Find(int id) const {
+        auto it = byId.find(id);
+        return it == byId.end() ? nullptr : it->second;
+    }
+
+    void Clear() {
+        for (auto& lane : lanes) lane = Lane();
+        byId.clear();
+    }
+
+    void ForEach(const function<void(const shared_ptr<ScheduledTask>&)>& f) const {
+        for (const auto& kv : byId) f(kv.second);
+    }
+};
+
+enum class TimerBackend { Heap, TimingWheel };
+
+// ɷȴľ. Ĭȵ (Windows ϳ 1-16 ms ĳٵ);
+// highResolution ʱֻȵǰ coarseMargin, ½߾ȶʱ,  spin ʱæ
+struct TimerPrecision {
+    bool highResolution = false;
+#ifdef _WIN32
+    chrono::microseconds coarseMargin = chrono::microseconds(16000); // ʱϵͳʱӽ (Ĭ 15.6 ms) 
+#else
+    chrono::microseconds coarseMargin = chrono::microseconds(2000);
+#endif
+    chrono::microseconds slack = chrono::microseconds(50); // ʱĳٵ (Windows TolerableDelay, Linux timer slack)
+    chrono::microseconds spin = chrono::microseconds(0);
+};
+
+// ߳ʹõĸ߾ȵζʱ: Windows ø߷ֱʿɵȴʱ, ƽ̨ nanosleep
+class PrecisionTimer {
+#ifdef _WIN32
+    HANDLE h = NULL;
+#else
+    long long appliedSlackNs = -1;
+#endif
+
+public:
+    PrecisionTimer() {
+#ifdef _WIN32
+        h = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!h) h = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS); // Windows 10 1803 ֮ǰָ֧߷ֱ
+#endif
+    }
+
+    PrecisionTimer(const PrecisionTimer&) = delete;
+    PrecisionTimer& operator=(const PrecisionTimer&) = delete;
+
+    ~PrecisionTimer() {
+#ifdef _WIN32
+        if (h) CloseHandle(h);
+#endif
+    }
+
+    void SleepUntil(SchedClock::time_point deadline, chrono::microseconds slack) {
+        auto left = chrono::duration_cast<chrono::nanoseconds>(deadline - SchedClock::now()).count();
+        if (left <= 0) return;
+#ifdef _WIN32
+        LARGE_INTEGER due;
+        due.QuadPart = -max<LONGLONG>(1, left / 100); // Ϊʱ, λ 100 ns
+        if (h && SetWaitableTimerEx(h, &due, 0, NULL, NULL, NULL, (ULONG)(slack.count() / 1000))) WaitForSingleObject(h, INFINITE);
+        else this_thread::sleep_until(deadline);
+#else
+#ifdef __linux__
+        long long slackNs = max<long long>(1, slack.count() * 1000);
+        if (slackNs != appliedSlackNs) { prctl(PR_SET_TIMERSLACK, (unsigned long)slackNs, 0, 0, 0); appliedSlackNs = slackNs; }
+#endif
+        timespec ts{ (time_t)(left / 1000000000), (long)(left % 1000000000) };
+        while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+#endif
+    }
+};
+
+// ȼͳƵĽֹʱ: ʱڽֹʱ, û, Ϊ.
+// withDeadline / missed ûе, runs ֻʵ, ûе skipped
+struct DeadlineStats {
+    uint64_t runs = 0;
+    uint64_t skipped = 0;       // رϲ /  / 
+    uint64_t withDeadline = 0;
+    uint64_t missed = 0;
+};
+
+// ɷٵ (ʵ - ƻʱ) Ķֱͼ: Ͱ 0 Ϊ < 1 us, Ͱ b Ϊ [2^(b-1), 2^b) us
+struct LatenessHistogram {
+    static constexpr int BUCKETS = 32;
+    uint64_t counts[BUCKETS] = {};
+    uint64_t n = 0;
+    int64_t maxUs = 0;
+
+    void Add(SchedClock::duration late) {
+        int64_t us = max<int64_t>(0, chrono::duration_cast<chrono::microseconds>(late).count());
+        ++counts[min(BUCKETS - 1, (int)bit_width((uint64_t)us))];
+        ++n;
+        maxUs = max(maxUs, us);
+    }
+
+    // λͰϽ (΢), ֵ
+    int64_t Percentile(double q) const {
+        if (!n) return 0;
+        uint64_t rank = max<uint64_t>(1, (uint64_t)ceil(q * (double)n));
+        uint64_t cum = 0;
+        for (int b = 0; b < BUCKETS; ++b) {
+            cum += counts[b];
+            if (cum >= rank) return min<int64_t>(maxUs, b == 0 ? 1 : (1LL << b));
+        }
+        return maxUs;
+    }
+
+    string Report() const {
+        ReportBuffer& rb = ReportBuffer::Begin();
+        rb.Text("Dispatch lateness over ").UInt(n).Text(" run(s): p50 <= ").Int(Percentile(0.50)).Text(" us, p90 <= ").Int(Percentile(0.90))
+            .Text(" us, p99 <= ").Int(Percentile(0.99)).Text(" us, p99.9 <= ").Int(Percentile(0.999)).Text(" us, max ").Int(maxUs).Text(" us.");
+        for (int b = 0; b < BUCKETS; ++b) {
+            if (!counts[b]) continue;
+            rb.Text(" [").Int(b == 0 ? 0 : (1LL << (b - 1))).Text("-").Int(1LL << b).Text(" us) ").UInt(counts[b]);
+        }
+        return rb.Str();
+    }
+};
+
+// ȡִ: ÿ worker һ˫˶, Լβ (LIFO) ȡ,
+// ʱ˳ worker ͷ (FIFO) ȡ. ⲿύ䵽,
+// worker ߳ڲύԼĶ.
+class WorkStealingExecutor {
+    struct WorkerQueue {
+        mutex m;
+        deque<function<void()>> jobs;
+    };
+
+    vector<unique_ptr<WorkerQueue>> queues;
+    vector<thread> threads;
+    mutex sleepMutex;
+    condition_variable sleepCv;
+    atomic<long> queued{ 0 };
+    atomic<unsigned> nextQueue{ 0 };
+    bool stopping = false;
+    bool drainOnStop = false;
+
+    static WorkStealingExecutor*& CurrentOwner() { static thread_local WorkStealingExecutor* owner = nullptr; return owner; }
+    static int& CurrentIndex() { static thread_local int index = -1; return index; }
+
+    bool TryPop(int self, function<void()>& job) {
+        int n = (int)queues.size();
+        {
+            WorkerQueue& own = *queues[self];
+            lock_guard<mutex> lock(own.m);
+            if (!own.jobs.empty()) { job = move(own.jobs.back()); own.jobs.pop_back(); return true; }
+        }
+        for (int k = 1; k < n; ++k) {
+            WorkerQueue& victim = *queues[(self + k) % n];
+            lock_guard<mutex> lock(victim.m);
+            if (!victim.jobs.empty()) { job = move(victim.jobs.front()); victim.jobs.pop_front(); return true; }
+        }
+        return false;
+    }
+
+    void WorkerMain(int self) {
+        CurrentOwner() = this;
+        CurrentIndex() = self;
+        while (true) {
+            function<void()> job;
+            if (TryPop(self, job)) {
+                --queued;
+                job();
+                continue;
+            }
+            unique_lock<mutex> lock(sleepMutex);
+            sleepCv.wait(lock, [this] { return stopping || queued > 0; });
+            if (stopping && (!drainOnStop || queued <= 0)) return;
+        }
+    }
+
+public:
+    explicit WorkStealingExecutor(int workerCount) {
+        workerCount = max(1, workerCount);
+        for (int i = 0; i < workerCount; ++i) queues.push_back(make_unique<WorkerQueue>());
+        for (int i = 0; i < workerCount; ++i) threads.emplace_back(&WorkStealingExecutor::WorkerMain, this, i);
+    }
+    ~WorkStealingExecutor() { Shutdown(false); }
+
+    int Size() const { return (int)queues.size(); }
+
+    // ֹͣ (Ҳſ) ʱ job; job ڷغ () 
+    void Submit(function<void()> job) {
+        int target = (CurrentOwner() == this) ? CurrentIndex() : (int)(nextQueue++ % queues.size());
+        {
+            lock_guard<mutex> lock(queues[target]->m);
+            {
+                lock_guard<mutex> sleepLock(sleepMutex);
+                if (stopping && !drainOnStop) return;
+                ++queued;
+            }
+            queues[target]->jobs.push_back(move(job));
+        }
+        sleepCv.notify_one();
+    }
+
+    // drain = true ʱִŶӵ˳, .  job ,
+    // Э job ȡЭ ( Resumption)
+    void Shutdown(bool drain) {
+        {
+            lock_guard<mutex> lock(sleepMutex);
+            if (stopping) return;
+            stopping = true;
+            drainOnStop = drain;
+        }
+        sleepCv.notify_all();
+        for (auto& t : threads) if (t.joinable()) t.join();
+        for (auto& q : queues) {
+            deque<function<void()>> dropped;
+            {
+                lock_guard<mutex> lock(q->m);
+                dropped.swap(q->jobs);
+            }
+        }
+    }
+};
+
+// Isolate: ʧֻӰ ( /  / ۶); GlobalFreeze: Ϊ, 
+enum class FailureMode { Isolate, GlobalFreeze };
+
+struct FailurePolicy {
+    int maxRetries = 3;                                   // ָ˱Դ
+    chrono::milliseconds baseDelay = chrono::milliseconds(500);
+    chrono::milliseconds maxDelay = chrono::milliseconds(30000);
+    int quarantineAfter = 5;                              // ʧ K κ
+    int breakerThreshold = 5;                             // ͬʧܴﵽϿ
+    chrono::milliseconds breakerCooldown = chrono::milliseconds(10000);
+};
+
+//  (GetName) ͳƵ۶: ʧܴﵽֵϿ,
+// ȴڽ뿪״̬, ֻһ̽, ̽ɹպ
+struct CircuitBreaker {
+    enum State { Closed, Open, HalfOpen } state = Closed;
+    int consecutiveFailures = 0;
+    bool probeInFlight = false;
+    SchedClock::time_point openUntil = {};
+
+    // ִʱͨ retryAt Ŷʱ
+    bool Allow(SchedClock::time_point now, const FailurePolicy& p, SchedClock::time_point& retryAt) {
+        if (state == Open) {
+            if (now < openUntil) { retryAt = openUntil; return false; }
+            state = HalfOpen;
+            probeInFlight = false;
+        }
+        if (state == HalfOpen) {
+            if (probeInFlight) { retryAt = now + p.baseDelay; return false; }
+            probeInFlight = true;
+        }
+        return true;
+    }
+
+    void OnSuccess() {
+        state = Closed;
+        consecutiveFailures = 0;
+        probeInFlight = false;
+    }
+
+    //  true ʾʧʹ۶ɱպ / 뿪ΪϿ
+    bool OnFailure(SchedClock::time_point now, const FailurePolicy& p) {
+        probeInFlight = false;
+        ++consecutiveFailures;
+        if (state == HalfOpen || consecutiveFailures >= p.breakerThreshold) {
+            bool opened = (state != Open);
+            state = Open;
+            openUntil = now + p.breakerCooldown;
+            return opened;
+        }
+        return false;
+    }
+};
+
+// ־ûõ׷дļ, Sync  (FlushFileBuffers / fsync)
+class DurableFile {
+#ifdef _WIN32
+    HANDLE h = INVALID_HANDLE_VALUE;
+#else
+    int fd = -1;
+#endif
+
+public:
+    DurableFile() = default;
+    DurableFile(const DurableFile&) = delete;
+    DurableFile& operator=(const DurableFile&) = delete;
+    ~DurableFile() { Close(); }
+
+    bool Open(const fs::path& p, bool truncate) {
+        Close();
+#ifdef _WIN32
+        h = CreateFileA(p.string().c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (h == INVALID_HANDLE_VALUE) return false;
+        SetFilePointer(h, 0, NULL, FILE_END);
+        return true;
+#else
+        fd = open(p.c_str(), O_WRONLY | O_CREAT | (truncate ? O_TRUNC : O_APPEND), 0644);
+        return fd >= 0;
+#endif
+    }
+
+    bool IsOpen() const {
+#ifdef _WIN32
+        return h != INVALID_HANDLE_VALUE;
+#else
+        return fd >= 0;
+#endif
+    }
+
+    bool Write(const void* data, size_t n) {
+        if (!IsOpen()) return false;
+        const char* p = (const char*)data;
+        while (n > 0) {
+#ifdef _WIN32
+            DWORD written = 0;
+            if (!WriteFile(h, p, (DWORD)min<size_t>(n, 1u << 30), &written, NULL)) return false;
+#else
+            ssize_t written = write(fd, p, n);
+            if (written < 0) { if (errno == EINTR) continue; return false; }
+#endif
+            p += written;
+            n -= (size_t)written;
+        }
+        return true;
+    }
+
+    bool Sync() {
+        if (!IsOpen()) return false;
+#ifdef _WIN32
+        return FlushFileBuffers(h) != 0;
+#else
+        return fsync(fd) == 0;
+#endif
+    }
+
+    void Close() {
+#ifdef _WIN32
+        if (h != INVALID_HANDLE_VALUE) CloseHandle(h);
+        h = INVALID_HANDLE_VALUE;
+#else
+        if (fd >= 0) close(fd);
+        fd = -1;
+#endif
+    }
+};
+
+// ־û״̬. kind Ϊ TaskFactory , ָʱݴ´
+struct TaskRecord {
+    int32_t id;
+    int32_t kind;
+    int64_t runTimeUs;  // ǽʱ (system_clock Ԫ΢); FixedRate ƻʱ nominal
+    int32_t intervalMs; // 0 ʾһ
+    uint32_t flags;     // bit 0: FixedRate; bit 1-2: overrun; bit 16-31: maxCatchUp
+    int32_t deadlineMs; // Խֹʱ, 0 ʾû
+    int32_t priority;   // TaskPriority
+};
+static_assert(sizeof(TaskRecord) == 32, "TaskRecord is written to disk as-is");
+
+struct PersistOptions {
+    string dir = "scheduler_state";
+    MissedRunPolicy missedRuns = MissedRunPolicy::FireOnce; // ͣڼ
+    int maxCatchUp = 100;
+    chrono::milliseconds commitInterval = chrono::milliseconds(10); // ύ
+    //  /  / ڷǰȴ. ĬϹر: Щ UI ߳, ܿ fsync ;
+    // رʱඪʧǰһ commitInterval ڵĲ
+    bool waitForCommit = false;
+    size_t snapshotEvery = 65536; // ϴοյ־¼ max(ֵ, ) ʱд
+};
+
+// Ԥд־ + . Ŀ¼ snapshot.bin ǴС gen ȫ־, wal-<gen>.log ˳ط.
+// ־¼: [u32 غɳ][u32 CRC32C][غ]; µĲȱβڻָʱ.
+// ׷ֻڴ滺, д̰߳ commitInterval (˵ȴʱ) д벢һ.
+class TaskWal {
+public:
+    struct State {
+        vector<TaskRecord> tasks;
+        int nextId = 1;
+        uint64_t gen = 0;     // Ŀ¼е
+        size_t replayed = 0;  // طŵ־¼
+        size_t tornBytes = 0; // Ĳȱβֽ
+    };
+
+private:
+    enum Op : uint8_t { OpUpsert = 1, OpRemove = 2, OpClear = 3 };
+    static constexpr uint32_t SNAP_MAGIC = 0x504E5354; // "TSNP"
+    static constexpr uint32_t SNAP_VERSION = 2;
+    static constexpr size_t RECORD_V1 = 24; // 汾 1 ļ¼û deadlineMs / priority
+    static constexpr size_t SNAP_HEADER = 28;
+    static constexpr size_t FLUSH_BYTES = 1 << 20;
+
+    struct Snapshot {
+        vector<TaskRecord> tasks;
+        int nextId;
+        uint64_t gen;
+    };
+
+    fs::path dir;
+    chrono::milliseconds commitInterval;
+    size_t snapshotEvery;
+
+    mutex m;
+    condition_variable cv, durableCv;
+    vector<pair<uint64_t, string>> segments; // (, дֽ), ׷˳
+    size_t pendingBytes = 0;
+    unique_ptr<Snapshot> pendingSnapshot;
+    uint64_t gen;
+    uint64_t appendedSeq = 0, durableSeq = 0;
+    size_t sinceSnapshot = 0;
+    int waiters = 0;
+    bool closing = false, exited = false;
+    thread writer;
+
+    static fs::path SnapPath(const fs::path& d) { return d / "snapshot.bin"; }
+    static fs::path WalPath(const fs::path& d, uint64_t g) { return d / ("wal-" + to_string(g) + ".log"); }
+
+    // wal-<gen>.log  true 
+    static bool ParseWalName(const string& name, uint64_t& g) {
+        if (name.size() <= 8 || name.compare(0, 4, "wal-") != 0 || name.compare(name.size() - 4, 4, ".log") != 0) return false;
+        const char* b = name.data() + 4;
+        const char* e = name.data() + name.size() - 4;
+        auto r = from_chars(b, e, g);
+        return r.ec == errc() && r.ptr == e;
+    }
+
+    static string ReadAll(const fs::path& p) {
+        ifstream in(p, ios::binary);
+        if (!in) throw runtime_error("cannot open " + p.string());
+        string data((size_t)fs::file_size(p), '\0');
+        if (!data.empty() && !in.read(data.data(), (streamsize)data.size())) throw runtime_error("read failed: " + p.string());
+        return data;
+    }
+
+    template <class T> static T Get(const char* p) { T v; memcpy(&v, p, sizeof(T)); return v; }
+    template <class T> static void Put(string& s, T v) { s.append((const char*)&v, sizeof(T)); }
+
+    // ɰ汾Ķ̼¼ȱٵֶȡ 0
+    static TaskRecord ReadRecord(const char* p, size_t size) {
+        TaskRecord r{};
+        memcpy(&r, p, min(size, sizeof(r)));
+        return r;
+    }
+
+    // ÷ m
+    uint64_t AppendLocked(const char* payload, uint32_t n) {
+        uint32_t crc = Crc32c::Update(0, (const uint8_t*)payload, n);
+        if (segments.empty() || segments.back().first != gen) segments.push_back({ gen, string() });
+        string& s = segments.back().second;
+        Put(s, n);
+        Put(s, crc);
+        s.append(payload, n);
+        pendingBytes += 8 + n;
+        ++sinceSnapshot;
+        return ++appendedSeq;
+    }
+
+    uint64_t Append(const char* payload, uint32_t n) {
+        uint64_t seq;
+        bool kick;
+        {
+            lock_guard<mutex> lock(m);
+            seq = AppendLocked(payload, n);
+            kick = pendingBytes >= FLUSH_BYTES;
+        }
+        if (kick) cv.notify_one();
+        return seq;
+    }
+
+    static void EncodeUpsert(char (&buf)[1 + sizeof(TaskRecord)], const TaskRecord& r) {
+        buf[0] = (char)OpUpsert;
+        memcpy(buf + 1, &r, sizeof(r));
+    }
+
+    bool SaveSnapshot(const Snapshot& snap) {
+        string header;
+        Put(header, SNAP_MAGIC);
+        Put(header, SNAP_VERSION);
+        Put(header, snap.gen);
+        Put(header, (int32_t)snap.nextId);
+        Put(header, (uint64_t)snap.tasks.size());
+        size_t body = snap.tasks.size() * sizeof(TaskRecord);
+        uint32_t crc = Crc32c::Update(0, (const uint8_t*)header.data(), header.size());
+        crc = Crc32c::Update(crc, (const uint8_t*)snap.tasks.data(), body);
+
+        fs::path tmp = dir / "snapshot.tmp";
+        DurableFile f;
+        bool ok = f.Open(tmp, true) && f.Write(header.data(), header.size())
+            && f.Write(snap.tasks.data(), body) && f.Write(&crc, sizeof(crc)) && f.Sync();
+        f.Close();
+        if (!ok) return false;
+        error_code ec;
+        fs::rename(tmp, SnapPath(dir), ec);
+        if (ec) return false;
+        // ¿ѸǾɴ־
+        for (const auto& e : fs::directory_iterator(dir, ec)) {
+            uint64_t g;
+            if (ParseWalName(e.path().filename().string(), g) && g < snap.gen) fs::remove(e.path(), ec);
+        }
+        return true;
+    }
+
+    void WriterLoop() {
+        DurableFile file;
+        uint64_t fileGen = 0;
+        bool reported = false;
+        unique_lock<mutex> lock(m);
+        while (true) {
+            cv.wait_for(lock, commitInterval, [this] {
+                return closing || pendingSnapshot || (!segments.empty() && (waiters > 0 || pendingBytes >= FLUSH_BYTES));
+            });
+            if (segments.empty() && !pendingSnapshot) {
+                if (closing) break;
+                continue;
+            }
+            auto batch = move(segments);
+            segments.clear();
+            pendingBytes = 0;
+            auto snap = move(pendingSnapshot);
+            uint64_t upto = appendedSeq;
+            lock.unlock();
+
+            bool ok = true;
+            for (const auto& seg : batch) {
+                if (!file.IsOpen() || fileGen != seg.first) {
+                    if (file.IsOpen()) ok = file.Sync() && ok;
+                    fileGen = seg.first;
+                    ok = file.Open(WalPath(dir, fileGen), false) && ok;
+                }
+                ok = file.Write(seg.second.data(), seg.second.size()) && ok;
+            }
+            if (!batch.empty()) ok = file.Sync() && ok;
+            if (snap) {
+                if (file.IsOpen() && fileGen < snap->gen) file.Close();
+                ok = SaveSnapshot(*snap) && ok;
+            }
+            if (!ok && !reported) {
+                Log("Persistence: write to " + dir.string() + " failed, recent changes may not survive a restart.");
+                reported = true;
+            }
+
+            lock.lock();
+            durableSeq = upto;
+            durableCv.notify_all();
+        }
+        exited = true;
+        durableCv.notify_all();
+    }
+
+public:
+    // ־Ӵ startGen ʼд, ׷ӵ (ܲȱ) ־ļ
+    TaskWal(fs::path d, uint64_t startGen, chrono::milliseconds interval, size_t every)
+        : dir(move(d)), commitInterval(interval), snapshotEvery(every), gen(startGen) {
+        writer = thread(&TaskWal::WriterLoop, this);
+    }
+
+    ~TaskWal() { Close(); }
+
+    // ɿ + ־ؽ; Ŀ¼ʱؿ״̬. ʱ쳣
+    static State Load(const fs::path& d) {
+        State st;
+        fs::create_directories(d);
+
+        fs::path snapPath = SnapPath(d);
+        if (fs::exists(snapPath)) {
+            string data = ReadAll(snapPath);
+            uint32_t version = data.size() >= SNAP_HEADER + 4 ? Get<uint32_t>(data.data() + 4) : 0;
+            size_t recSize = version == 1 ? RECORD_V1 : sizeof(TaskRecord);
+            bool ok = (version == 1 || version == SNAP_VERSION) && Get<uint32_t>(data.data()) == SNAP_MAGIC;
+            uint64_t count = ok ? Get<uint64_t>(data.data() + 20) : 0;
+            ok = ok && count <= (data.size() - SNAP_HEADER - 4) / recSize
+                && data.size() == SNAP_HEADER + count * recSize + 4
+                && Crc32c::Update(0, (const uint8_t*)data.data(), data.size() - 4) == Get<uint32_t>(data.data() + data.size() - 4);
+            if (!ok) throw runtime_error("corrupt snapshot " + snapPath.string());
+            st.gen = Get<uint64_t>(data.data() + 8);
+            st.nextId = Get<int32_t>(data.data() + 16);
+            st.tasks.resize((size_t)count);
+            if (recSize == sizeof(TaskRecord)) memcpy(st.tasks.data(), data.data() + SNAP_HEADER, (size_t)count * sizeof(TaskRecord));
+            else for (size_t i = 0; i < count; ++i) st.tasks[i] = ReadRecord(data.data() + SNAP_HEADER + i * recSize, recSize);
+        }
+
+        vector<uint64_t> gens;
+        for (const auto& e : fs::directory_iterator(d)) {
+            uint64_t g;
+            if (ParseWalName(e.path().filename().string(), g) && g >= st.gen) gens.push_back(g);
+        }
+        sort(gens.begin(), gens.end());
+
+        // ֻ־м¼ʱŽ id ; ɾ id = 0, ͳһѹ
+        unordered_map<int32_t, size_t> index;
+        bool indexed = false;
+        for (uint64_t g : gens) {
+            st.gen = max(st.gen, g);
+            string data = ReadAll(WalPath(d, g));
+            size_t pos = 0;
+            while (pos + 8 <= data.size()) {
+                uint32_t n = Get<uint32_t>(data.data() + pos);
+                const char* p = data.data() + pos + 8;
+                if (n == 0 || n > data.size() - pos - 8 || Crc32c::Update(0, (const uint8_t*)p, n) != Get<uint32_t>(data.data() + pos + 4)) break;
+                if (!indexed) {
+                    index.reserve(st.tasks.size());
+                    for (size_t i = 0; i < st.tasks.size(); ++i) index[st.tasks[i].id] = i;
+                    indexed = true;
+                }
+                if (p[0] == OpUpsert && (n == 1 + sizeof(TaskRecord) || n == 1 + RECORD_V1)) {
+                    TaskRecord r = ReadRecord(p + 1, n - 1);
+                    auto it = index.find(r.id);
+                    if (it != index.end()) st.tasks[it->second] = r;
+                    else { index[r.id] = st.tasks.size(); st.tasks.push_back(r); }
+                    st.nextId = max(st.nextId, r.id + 1);
+                }
+                else if (p[0] == OpRemove && n == 1 + sizeof(int32_t)) {
+                    auto it = index.find(Get<int32_t>(p + 1));
+                    if (it != index.end()) { st.tasks[it->second].id = 0; index.erase(it); }
+                }
+                else if (p[0] == OpClear) {
+                    st.tasks.clear();
+                    index.clear();
+                }
+                pos += 8 + n;
+                ++st.replayed;
+            }
+            st.tornBytes += data.size() - pos;
+        }
+        if (indexed) st.tasks.erase(remove_if(st.tasks.begin(), st.tasks.end(), [](const TaskRecord& r) { return r.id == 0; }), st.tasks.end());
+        return st;
+    }
+
+    // ־, ɽ WaitDurable
+    uint64_t Upsert(const TaskRecord& r) {
+        char buf[1 + sizeof(TaskRecord)];
+        EncodeUpsert(buf, r);
+        return Append(buf, sizeof(buf));
+    }
+
+    // һμ׷Ӷ, һ
+    uint64_t UpsertAll(const vector<TaskRecord>& rs) {
+        uint64_t seq = 0;
+        bool kick;
+        {
+            lock_guard<mutex> lock(m);
+            char buf[1 + sizeof(TaskRecord)];
+            for (const auto& r : rs) {
+                EncodeUpsert(buf, r);
+                seq = AppendLocked(buf, sizeof(buf));
+            }
+            kick = pendingBytes >= FLUSH_BYTES;
+        }
+        if (kick) cv.notify_one();
+        return seq;
+    }
+
+    uint64_t Remove(int32_t id) {
+        char buf[1 + sizeof(int32_t)];
+        buf[0] = (char)OpRemove;
+        memcpy(buf + 1, &id, sizeof(id));
+        return Append(buf, sizeof(buf));
+    }
+
+    uint64_t Clear() {
+        char op = (char)OpClear;
+        return Append(&op, 1);
+    }
+
+    bool SnapshotDue(size_t live) {
+        lock_guard<mutex> lock(m);
+        return sinceSnapshot >= max(snapshotEvery, live);
+    }
+
+    // лһ־, д߳дպɾɴ־.
+    // tasks ǡ÷ӳлǰȫ׷ (÷ͬһռ)
+    void WriteSnapshot(vector<TaskRecord> tasks, int nextId) {
+        {
+            lock_guard<mutex> lock(m);
+            ++gen;
+            sinceSnapshot = 0;
+            pendingSnapshot = make_unique<Snapshot>(Snapshot{ move(tasks), nextId, gen });
+        }
+        cv.notify_one();
+    }
+
+    // ȴ seq ֮ǰļ¼; ͬһڵĵȴ߹һ
+    void WaitDurable(uint64_t seq) {
+        unique_lock<mutex> lock(m);
+        if (seq <= durableSeq) return;
+        ++waiters;
+        cv.notify_one();
+        durableCv.wait(lock, [&] { return durableSeq >= seq || exited; });
+        --waiters;
+    }
+
+    // дʣ¼ֹͣд߳
+    void Close() {
+        { lock_guard<mutex> lock(m); closing = true; }
+        cv.notify_one();
+        if (writer.joinable()) writer.join();
+    }
+};
+
+// ִжвѯ: ıֻΪǲ, ʽ
+struct PendingRow {
+    int id;
+    string text;
+    SchedClock::time_point runTime;
+    bool quarantined;
+
+    //  QueryPending ͬ˳: , ఴ (runTime, id)
+    static bool Less(const PendingRow& a, const PendingRow& b) {
+        if (a.quarantined != b.quarantined) return b.quarantined;
+        if (a.runTime != b.runTime) return a.runTime < b.runTime;
+        return a.id < b.id;
+    }
+};
+
+struct PendingPage {
+    uint64_t version = 0;  // а汾, κɾĶ
+    size_t total = 0;      //  () е
+    vector<PendingRow> rows;
+};
+
+struct PendingDelta {
+    uint64_t version = 0;
+    size_t total = 0;
+    bool fullResync = false; // 汾̫ (־ѽضϻб), Ҫȡҳ
+    vector<PendingRow> upserts;
+    vector<int> removed;
+};
+
+class TaskScheduler {
+    unique_ptr<ITimerStore> timers = make_unique<TaskHeap>();
+    mutex listMutex;
+    condition_variable cv;
+    bool running = true;
+    thread dispatcherThread;
+    unique_ptr<WorkStealingExecutor> executor;
+    int inFlight = 0; // ռ worker  (첽 Start غó)
+    int nextId = 1;
+    bool isFrozen = false;
+
+    // ڼڴͣ, ռ worker; RESET ʱִβ
+    struct ParkedFinish {
+        shared_ptr<ScheduledTask> task;
+        bool failed;
+        string error;
+        SchedClock::time_point finishedAt;
+    };
+    vector<ParkedFinish> parked;
+
+    FailureMode failureMode = FailureMode::Isolate;
+    FailurePolicy policy;
+    unordered_map<string, CircuitBreaker> breakers;
+    unordered_map<int, shared_ptr<ScheduledTask>> quarantined;
+    mt19937 jitterRng{ random_device{}() };
+
+    // ִмϵİ汾н־, ҳ / ѯʹ
+    enum class PendingOp { Upsert, Remove };
+    struct PendingChange {
+        uint64_t version;
+        PendingOp op;
+        int id;
+    };
+    static const size_t JOURNAL_LIMIT = 4096;
+    uint64_t pendingVersion = 0;
+    uint64_t resyncBefore = 0;
+    deque<PendingChange> journal;
+    atomic<bool> refreshQueued{ false };
+
+    // ʱ (Эָ̻): ںֱӽִ, , Ҳڴִб
+    struct Wakeup {
+        SchedClock::time_point at;
+        uint64_t seq;
+        function<void()> fn;
+        bool operator>(const Wakeup& o) const { return at != o.at ? at > o.at : seq > o.seq; }
+    };
+    priority_queue<Wakeup, vector<Wakeup>, greater<Wakeup>> wakeups;
+    uint64_t wakeupSeq = 0;
+
+    // ־û: δʱ wal Ϊ. active ΪȡִСδŻĳ־, Ҫ
+    unique_ptr<TaskWal> wal;
+    PersistOptions persist;
+    unordered_map<int, shared_ptr<ScheduledTask>> active;
+
+    TimerPrecision precision;
+    PrecisionTimer precisionTimer; // ֻɷ߳ʹ
+    LatenessHistogram lateness;
+
+    // , ٰȼ + EDF ȡ
+    ReadyQueue ready;
+    SchedClock::duration agingStep = DEFAULT_AGING_STEP;
+    array<DeadlineStats, PRIORITY_CLASSES> deadlineStats;
+
+    // º÷ listMutex
+    void Journal(PendingOp op, int id) {
+        journal.push_back({ ++pendingVersion, op, id });
+        if (journal.size() > JOURNAL_LIMIT) journal.pop_front();
+    }
+
+    void JournalReset() {
+        journal.clear();
+        resyncBefore = ++pendingVersion;
+    }
+
+    // Ԥд־, δ־ûʱΪ 0
+    uint64_t Enqueue(const shared_ptr<ScheduledTask>& st) {
+        timers->Push(st);
+        Journal(PendingOp::Upsert, st->id);
+        if (!wal || !st->kind || !running) return 0;
+        active.erase(st->id);
+        uint64_t seq = wal->Upsert(ToRecord(*st, WallOffsetUs()));
+        MaybeSnapshot();
+        return seq;
+    }
+
+    // ־ ( /  / ) ʱ¼ɾ
+    uint64_t Retire(const ScheduledTask& st) {
+        if (!wal || !st.kind || !running) return 0;
+        active.erase(st.id);
+        uint64_t seq = wal->Remove(st.id);
+        MaybeSnapshot();
+        return seq;
+    }
+
+    //  spec Ŀ (id ɵ÷ڷ)
+    static shared_ptr<ScheduledTask> MakeEntry(const TaskSpec& spec, SchedClock::time_point now) {
+        auto st = make_shared<ScheduledTask>();
+        st->task = spec.task;
+        st->kind = spec.kind;
+        st->runTime = st->nominal = now + chrono::milliseconds(spec.delayMs);
+        st->interval = chrono::milliseconds(spec.intervalMs);
+        st->isPeriodic = (spec.intervalMs > 0);
+        st->mode = spec.mode;
+        st->overrun = spec.overrun;
+        st->maxCatchUp = min(max(1, spec.maxCatchUp), 0xFFFF);
+        st->priority = spec.priority;
+        st->relDeadline = chrono::milliseconds(max(0, spec.deadlineMs));
+        return st;
+    }
+
+    // ǽʱ뵥ʱ֮ (΢); ־ûʱ̱Ч, ǽʱ洢
+    static int64_t WallOffsetUs() {
+        return chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count()
+            - chrono::duration_cast<chrono::microseconds>(SchedClock::now().time_since_epoch()).count();
+    }
+
+    static TaskRecord ToRecord(const ScheduledTask& st, int64_t wallOffsetUs) {
+        bool rate = st.isPeriodic && st.mode == PeriodMode::FixedRate;
+        auto at = rate ? st.nominal : st.runTime;
+        uint32_t flags = (rate ? 1u : 0u) | ((uint32_t)st.overrun << 1) | ((uint32_t)st.maxCatchUp << 16);
+        int64_t us = chrono::duration_cast<chrono::microseconds>(at.time_since_epoch()).count() + wallOffsetUs;
+        return { st.id, st.kind, us, (int32_t)st.interval.count(), flags, (int32_t)st.relDeadline.count(), (int32_t)st.priority };
+    }
+
+    // : õȴû
+    void WaitCommitted(uint64_t seq) {
+        if (seq && persist.waitForCommit) wal->WaitDurable(seq);
+    }
+
+    // ־൱ʱд, ̯ÿαΪ O(1)
+    void MaybeSnapshot() {
+        size_t live = timers->Size() + ready.Size() + quarantined.size() + active.size();
+        if (!wal->SnapshotDue(live)) return;
+        vector<TaskRecord> records;
+        records.reserve(live);
+        int64_t offset = WallOffsetUs();
+        auto add = [&](const shared_ptr<ScheduledTask>& t) { if (t->kind) records.push_back(ToRecord(*t, offset)); };
+        timers->ForEach(add);
+        ready.ForEach(add);
+        for (const auto& kv : quarantined) add(kv.second);
+        for (const auto& kv : active) add(kv.second);
+        wal->WriteSnapshot(move(records), nextId);
+    }
+
+    // ָʱͣڼ;  false ʾ
+    static bool ApplyMissedRun(ScheduledTask& st, SchedClock::time_point now, const PersistOptions& opt) {
+        if (!st.isPeriodic) {
+            if (opt.missedRuns == MissedRunPolicy::Skip) return false;
+            st.runTime = now;
+            return true;
+        }
+        long long missed = (now - st.runTime) / st.interval + 1;
+        switch (opt.missedRuns) {
+        case MissedRunPolicy::Skip:
+            st.runTime += st.interval * missed;
+            st.nominal = st.runTime;
+            break;
+        case MissedRunPolicy::FireAll: {
+            long long n = min<long long>(missed, max(1, opt.maxCatchUp));
+            // FixedRate  NextPeriod ؼƻʱ; FixedDelay ü
+            if (st.mode == PeriodMode::FixedRate) st.nominal = st.runTime + st.interval * (missed - n);
+            else st.catchUp = (int)n - 1;
+            st.runTime = now;
+            break;
+        }
+        default:
+            st.nominal = st.runTime + st.interval * (missed - 1);
+            st.runTime = now;
+            break;
+        }
+        return true;
+    }
+
+    // һʱ; رϲ /  / 
+    static long long NextPeriod(ScheduledTask& st, SchedClock::time_point now) {
+        if (st.catchUp > 0) { --st.catchUp; st.runTime = now; return 0; }
+        if (st.mode == PeriodMode::FixedDelay) { st.runTime = now + st.interval; return 0; }
+        auto next = st.nominal + st.interval;
+        if (next > now) { st.nominal = st.runTime = next; return 0; }
+        long long missed = (now - next) / st.interval + 1; // ѹڵļƻʱ ( next)
+        switch (st.overrun) {
+        case MissedRunPolicy::Skip:
+            st.nominal = st.runTime = next + st.interval * missed;
+            return missed;
+        case MissedRunPolicy::FireAll: {
+            long long dropped = max(0LL, missed - st.maxCatchUp);
+            st.nominal = next + st.interval * dropped;
+            st.runTime = now;
+            return dropped;
+        }
+        default:
+            st.nominal = next + st.interval * (missed - 1);
+            st.runTime = now;
+            return missed - 1;
+        }
+    }
+
+    // ʱ FixedRate ѵƻʱȴһֱûе (类ȼס)  skipped,
+    // ѹҲ, δеͳﲻۼ (÷ listMutex)
+    void CountUnrun(const ScheduledTask& st, SchedClock::time_point now) {
+        if (!st.isPeriodic || st.mode != PeriodMode::FixedRate || st.nominal > now) return;
+        DeadlineStats& ds = deadlineStats[(int)st.priority];
+        ds.skipped += (uint64_t)((now - st.nominal) / st.interval + 1);
+        if (st.relDeadline.count() > 0 && st.nominal + st.relDeadline <= now) {
+            uint64_t late = (uint64_t)((now - st.nominal - st.relDeadline) / st.interval + 1);
+            ds.withDeadline += late;
+            ds.missed += late;
+        }
+    }
+
+    struct RowKey {
+        int id;
+        SchedClock::time_point runTime;
+        bool periodic;
+        bool quarantined;
+        TaskPriority priority;
+    };
+
+    static bool RowLess(const RowKey& a, const RowKey& b) {
+        if (a.quarantined != b.quarantined) return b.quarantined;
+        if (a.runTime != b.runTime) return a.runTime < b.runTime;
+        return a.id < b.id;
+    }
+
+    // ÷ listMutex; ڷ nullptr
+    shared_ptr<ScheduledTask> FindPending(int id, bool& isQuarantined) const {
+        isQuarantined = false;
+        if (auto st = timers->Find(id)) return st;
+        if (auto st = ready.Find(id)) return st;
+        auto it = quarantined.find(id);
+        if (it == quarantined.end()) return nullptr;
+        isQuarantined = true;
+        return it->second;
+    }
+
+    // ֻȡ, ʽ
+    vector<PendingRow> FormatRows(const vector<RowKey>& keys) {
+        vector<pair<RowKey, shared_ptr<ITask>>> items;
+        items.reserve(keys.size());
+        {
+            lock_guard<mutex> lock(listMutex);
+            for (const auto& k : keys) {
+                bool q;
+                auto st = FindPending(k.id, q);
+                if (st) items.push_back({ k, st->task });
+            }
+        }
+        vector<PendingRow> rows;
+        rows.reserve(items.size());
+        for (const auto& it : items) {
+            const RowKey& k = it.first;
+            string text = k.quarantined ? "[--:--:--] " : "[" + ScheduledTask::TimeStr(k.runTime) + "] ";
+            text += it.second->GetName();
+            static const char* CLASS_NAMES[] = { "Critical", "High", "", "Low" };
+            string tags = k.quarantined ? "Quarantined" : k.periodic ? "Loop" : "";
+            if (*CLASS_NAMES[(int)k.priority]) tags += (tags.empty() ? "" : ", ") + string(CLASS_NAMES[(int)k.priority]);
+            if (!tags.empty()) text += " (" + tags + ")";
+            rows.push_back({ k.id, move(text), k.runTime, k.quarantined });
+        }
+        return rows;
+    }
+
+    TaskScheduler() : executor(make_unique<WorkStealingExecutor>(DefaultWorkerCount())) {
+        LogWriter::Instance(); // ȹ־, ֤ڵ, ˳ʱ worker Կд־
+        dispatcherThread = thread(&TaskScheduler::DispatchLoop, this);
+    }
+
+    // ϲˢ: ֻһ WM_UPDATE_LIST, ʱ ListRefreshed λ
+    void RefreshUI() {
+#ifdef _WIN32
+        if (hGlobalWnd && !refreshQueued.exchange(true)) PostMessageA(hGlobalWnd, WM_UPDATE_LIST, 0, 0);
+#endif
+    }
+
+    // ֻп worker ʱŴӶʱ洢ȡ, ڶпɱ
+    void DispatchLoop() {
+        while (true) {
+            shared_ptr<ScheduledTask> currentTask = nullptr;
+
+            {
+                unique_lock<mutex> lock(listMutex);
+                cv.wait(lock, [this] {
+                    return (!isFrozen && (((!timers->Empty() || !ready.Empty()) && inFlight < executor->Size()) || !wakeups.empty())) || !running;
+                });
+
+                if (!running) break;
+
+                auto now = SchedClock::now();
+                bool resumed = false;
+                while (!wakeups.empty() && wakeups.top().at <= now) {
+                    executor->Submit(move(const_cast<Wakeup&>(wakeups.top()).fn));
+                    wakeups.pop();
+                    resumed = true;
+                }
+                bool canRun = (!timers->Empty() || !ready.Empty()) && inFlight < executor->Size();
+                if (canRun) {
+                    while (auto due = timers->PopDue(now)) ready.Push(move(due));
+                    currentTask = ready.Pop(now, agingStep);
+                }
+                if (!currentTask) {
+                    if (resumed) continue;
+                    if (canRun && !timers->Empty() && (wakeups.empty() || timers->NextWakeup() < wakeups.top().at)) WaitDue(lock, timers->NextWakeup());
+                    else if (!wakeups.empty()) WaitDue(lock, wakeups.top().at);
+                    else cv.wait(lock);
+                    continue;
+                }
+                Journal(PendingOp::Remove, currentTask->id);
+                if (wal && currentTask->kind) active[currentTask->id] = currentTask;
+                ++inFlight;
+                // ύ, ֤ SetWorkerCount µִյ
+                executor->Submit([this, currentTask] { RunTask(currentTask); });
+            }
+
+            RefreshUI();
+        }
+    }
+
+    // ȵ deadline 򱻻 (÷ lock). ߾ģʽ coarseMargin ڷſ˯ڶʱ,
+    // ڼ¼ĸ౻Ƴ coarseMargin
+    void WaitDue(unique_lock<mutex>& lock, SchedClock::time_point deadline) {
+        if (!precision.highResolution) { cv.wait_until(lock, deadline); return; }
+        if (deadline - SchedClock::now() > precision.coarseMargin) { cv.wait_until(lock, deadline - precision.coarseMargin); return; }
+        TimerPrecision p = precision;
+        lock.unlock();
+        precisionTimer.SleepUntil(deadline - p.spin, p.slack);
+        while (SchedClock::now() < deadline) this_thread::yield();
+        lock.lock();
+    }
+
+    //  attempt Եĵȴʱ: ָ˱,  [d/2, d] ھȶ (÷ listMutex)
+    chrono::milliseconds Backoff(int attempt) {
+        long long d = policy.baseDelay.count();
+        for (int i = 1; i < attempt && d < policy.maxDelay.count(); ++i) d *= 2;
+        d = min<long long>(d, policy.maxDelay.count());
+        uniform_int_distribution<long long> jitter(d / 2, d);
+        return chrono::milliseconds(jitter(jitterRng));
+    }
+
+    void RunTask(shared_ptr<ScheduledTask> currentTask) {
+        string name = currentTask->task->GetName();
+
+        // ۶Ͽʱִ, ֱƳٵȴ
+        SchedClock::time_point retryAt;
+        bool allowed = true;
+        {
+            lock_guard<mutex> lock(listMutex);
+            auto now = SchedClock::now();
+            if (failureMode == FailureMode::Isolate) {
+                allowed = breakers[name].Allow(now, policy, retryAt);
+                if (!allowed) {
+                    --inFlight;
+                    currentTask->runTime = retryAt;
+                    Enqueue(currentTask);
+                }
+            }
+            if (allowed) lateness.Add(now - currentTask->runTime);
+            // ֻͳ֮ļ,  / Ƴٺ¼
+            if (allowed && currentTask->isPeriodic) {
+                if (currentTask->failures == 0 && currentTask->lastStart != SchedClock::time_point{})
+                    currentTask->jitter.Add(chrono::duration<double, milli>(now - currentTask->lastStart - currentTask->interval).count());
+                currentTask->lastStart = currentTask->failures == 0 ? now : SchedClock::time_point{};
+            }
+        }
+        if (!allowed) {
+            cv.notify_all();
+            Log("Circuit open, deferred: " + name);
+            RefreshUI();
+            return;
+        }
+
+        // ͬ Start ɲֱβ; 첽 done ⲿ߳, βתִ,
+        // ⲿ߳ȴ
+        thread::id worker = this_thread::get_id();
+        currentTask->task->Start([this, currentTask, worker](bool failed, const string& error) {
+            if (this_thread::get_id() == worker) { Finish(currentTask, failed, error); return; }
+            lock_guard<mutex> lock(listMutex);
+            executor->Submit([this, currentTask, failed, error] { Finish(currentTask, failed, error); });
+        });
+
+        // ѽת̨ȴ, ͷ worker 
+        {
+            lock_guard<mutex> lock(listMutex);
+            --inFlight;
+        }
+        cv.notify_all();
+    }
+
+    void Finish(shared_ptr<ScheduledTask> currentTask, bool failed, const string& error) {
+        bool freeze = false, freezing = false, park = false;
+        {
+            lock_guard<mutex> lock(listMutex);
+            freeze = failed && failureMode == FailureMode::GlobalFreeze;
+            park = freeze || isFrozen;
+            if (park) {
+                freezing = !isFrozen;
+                isFrozen = true;
+                parked.push_back({ currentTask, failed, error, SchedClock::now() });
+            }
+        }
+        if (!park) { Complete(currentTask, failed, error, SchedClock::now()); return; }
+        if (freeze) {
+            Log("SYSTEM FAILURE: " + error);
+            if (freezing) Log("!!! SYSTEM FROZEN !!!");
+        }
+    }
+
+    // β: ͳ,  /  /  / . finishedAt Ϊʵʽʱ
+    void Complete(shared_ptr<ScheduledTask> currentTask, bool failed, const string& error, SchedClock::time_point finishedAt) {
+        string name = currentTask->task->GetName();
+        enum { Done, Rescheduled, Retry, GaveUp, Quarantined } outcome = Done;
+        bool breakerOpened = false;
+        chrono::milliseconds delay(0);
+        long long overrun = 0;
+        JitterStats jitter;
+        {
+            lock_guard<mutex> lock(listMutex);
+            auto now = SchedClock::now();
+            DeadlineStats& ds = deadlineStats[(int)currentTask->priority];
+            ++ds.runs;
+            if (currentTask->deadline != SchedClock::time_point::max()) {
+                ++ds.withDeadline;
+                if (finishedAt > currentTask->deadline) ++ds.missed;
+            }
+            if (!failed || failureMode == FailureMode::GlobalFreeze) {
+                if (!failed) {
+                    currentTask->failures = 0;
+                    breakers[name].OnSuccess();
+                }
+                if (currentTask->isPeriodic && running) {
+                    overrun = NextPeriod(*currentTask, now);
+                    Enqueue(currentTask);
+                    outcome = Rescheduled;
+                }
+            }
+            else if (running) {
+                breakerOpened = breakers[name].OnFailure(now, policy);
+                int attempt = ++currentTask->failures;
+                if (attempt >= policy.quarantineAfter) {
+                    quarantined[currentTask->id] = currentTask;
+                    active.erase(currentTask->id);
+                    Journal(PendingOp::Upsert, currentTask->id);
+                    outcome = Quarantined;
+                }
+                else if (attempt <= policy.maxRetries) {
+                    delay = Backoff(attempt);
+                    currentTask->runTime = now + delay;
+                    Enqueue(currentTask);
+                    outcome = Retry;
+                }
+                else if (currentTask->isPeriodic) {
+                    overrun = NextPeriod(*currentTask, now);
+                    Enqueue(currentTask);
+                    outcome = Rescheduled;
+                }
+                else {
+                    outcome = GaveUp;
+                }
+            }
+            if (outcome == Done || outcome == GaveUp) Retire(*currentTask);
+            jitter = currentTask->jitter;
+            // رϲ /  / ڼ skipped, ޵Ҳ
+            ds.skipped += overrun;
+            if (overrun && currentTask->relDeadline.count() > 0) {
+                ds.withDeadline += overrun;
+                ds.missed += overrun;
+            }
+        }
+        cv.notify_all();
+
+        if (failed && failureMode == FailureMode::Isolate) {
+            Log("FAILED: " + name + " (" + error + "), consecutive failures: " + to_string(currentTask->failures));
+            if (breakerOpened) Log("Circuit OPEN for " + to_string(policy.breakerCooldown.count()) + " ms: " + name);
+        }
+        switch (outcome) {
+        case Rescheduled: {
+            ReportBuffer& msg = ReportBuffer::Begin();
+            msg.Text("Rescheduled: ").Text(name);
+            if (jitter.n) {
+                msg.Text(" (jitter mean ").Fixed(jitter.mean, 1).Text(" / sd ").Fixed(jitter.StdDev(), 1).Text(" / max ")
+                    .Fixed(jitter.maxAbs, 1).Text(" ms over ").UInt(jitter.n).Text(" periods)");
+            }
+            Log(msg.Str());
+            if (overrun) {
+                static const char* VERBS[] = { "coalesced", "dropped beyond catch-up cap", "skipped" };
+                Log("Overrun: " + to_string(overrun) + " missed run(s) " + VERBS[(int)currentTask->overrun] + ": " + name);
+            }
+            break;
+        }
+        case Retry: Log("Retry #" + to_string(currentTask->failures) + " in " + to_string(delay.count()) + " ms: " + name); break;
+        case GaveUp: Log("Gave up after " + to_string(currentTask->failures) + " attempts: " + name); break;
+        case Quarantined: Log("Quarantined (press RESET to release): " + name); break;
+        default: break;
+        }
+        if (outcome != Done) RefreshUI();
+    }
+
+public:
+    static TaskScheduler& Instance() { static TaskScheduler i; return i; }
+    ~TaskScheduler() { Stop(); }
+
+    static int DefaultWorkerCount() { return max(2, (int)thread::hardware_concurrency()); }
+
+    // ÿ:  / нֹʱ (), ʵ, Լûе
+    static string FormatDeadlines(const array<DeadlineStats, PRIORITY_CLASSES>& stats) {
+        static const char* CLASS_NAMES[] = { "Critical", "High", "Normal", "Low" };
+        ReportBuffer& rb = ReportBuffer::Begin();
+        rb.Text("Deadlines missed by class:");
+        for (int c = 0; c < PRIORITY_CLASSES; ++c) {
+            rb.Text(c ? ", " : " ").Text(CLASS_NAMES[c]).Text(" ").UInt(stats[c].missed).Text("/").UInt(stats[c].withDeadline);
+            if (stats[c].withDeadline) rb.Text(" (").Fixed(100.0 * stats[c].missed / stats[c].withDeadline, 1).Text("%)");
+            rb.Text(" of ").UInt(stats[c].runs).Text(" runs");
+            if (stats[c].skipped) rb.Text(" + ").UInt(stats[c].skipped).Text(" skipped");
+        }
+        return rb.Str();
+    }
+
+    void Stop() {
+        decltype(wakeups) dropped;
+        { lock_guard<mutex> lock(listMutex); running = false; isFrozen = false; dropped.swap(wakeups); }
+        cv.notify_all();
+        if (dispatcherThread.joinable()) dispatcherThread.join();
+        executor->Shutdown(false);
+        dropped = decltype(wakeups)();   // δڵ
+        if (wal) wal->Close();
+    }
+
+    //  worker ; ִִѽ˳
+    void SetWorkerCount(int n) {
+        auto next = make_unique<WorkStealingExecutor>(n);
+        unique_ptr<WorkStealingExecutor> old;
+        {
+            lock_guard<mutex> lock(listMutex);
+            old = move(executor);
+            executor = move(next);
+        }
+        cv.notify_all();
+        old->Shutdown(true);
+        Log("Workers: " + to_string(max(1, n)));
+    }
+
+    // RESET: ȫֶ, ͬʱų񲢱պ۶
+    void UnfreezeSystem() {
+        bool wasFrozen = false;
+        size_t released = 0;
+        vector<ParkedFinish> resumed;
+        {
+            lock_guard<mutex> lock(listMutex);
+            wasFrozen = isFrozen;
+            isFrozen = false;
+            resumed.swap(parked);
+            for (auto& p : resumed)
+                executor->Submit([this, p] { Complete(p.task, p.failed, p.error, p.finishedAt); });
+            auto now = SchedClock::now();
+            for (auto& kv : quarantined) {
+                kv.second->failures = 0;
+                kv.second->runTime = now;
+                Enqueue(kv.second);
+            }
+            released = quarantined.size();
+            quarantined.clear();
+            breakers.clear();
+            if (!wasFrozen && released == 0) {
+                Log("System normal.");
+                if (lateness.n) Log(lateness.Report());
+                if (any_of(deadlineStats.begin(), deadlineStats.end(), [](const DeadlineStats& d) { return d.withDeadline > 0; }))
+                    Log(FormatDeadlines(deadlineStats));
+                return;
+            }
+        }
+        if (wasFrozen) {
+            Log("-> RESET Signal Received.");
+            Log(">>> SYSTEM RECOVERED. <<< " + to_string(resumed.size()) + " parked task(s) resumed.");
+        }
+        if (released) Log("-> Released " + to_string(released) + " quarantined task(s).");
+        cv.notify_all();
+        RefreshUI();
+    }
+
+    void SetFailureMode(FailureMode mode) {
+        { lock_guard<mutex> lock(listMutex); failureMode = mode; }
+        Log(mode == FailureMode::GlobalFreeze ? "Failure mode: global freeze" : "Failure mode: per-task isolation");
+    }
+
+    void SetFailurePolicy(const FailurePolicy& p) {
+        lock_guard<mutex> lock(listMutex);
+        policy = p;
+    }
+
+    // лʱ洢, ŶӵԭǨ; tickMs ʱЧ
+    void SetTimerBackend(TimerBackend backend, int tickMs = 1) {
+        unique_ptr<ITimerStore> next;
+        if (backend == TimerBackend::TimingWheel) next = make_unique<TimingWheel>(chrono::milliseconds(tickMs));
+        else next = make_unique<TaskHeap>();
+        string name = next->GetName();
+        {
+            lock_guard<mutex> lock(listMutex);
+            vector<shared_ptr<ScheduledTask>> pending;
+            timers->ForEach([&](const shared_ptr<ScheduledTask>& t) { pending.push_back(t); });
+            timers->Clear();
+            next->PushAll(pending);
+            timers = move(next);
+        }
+        cv.notify_all();
+        Log("Timer backend: " + name);
+    }
+
+    void SetTimerPrecision(const TimerPrecision& p) {
+        { lock_guard<mutex> lock(listMutex); precision = p; }
+        cv.notify_all();
+        if (!p.highResolution) { Log("Timer precision: condition variable"); return; }
+        Log("Timer precision: high resolution (slack " + to_string(p.slack.count()) + " us, spin " + to_string(p.spin.count()) + " us)");
+    }
+
+    // ȼÿȴ step һ; 0 ر
+    static constexpr chrono::milliseconds DEFAULT_AGING_STEP{ 2000 };
+    void SetAgingStep(chrono::milliseconds step) {
+        lock_guard<mutex> lock(listMutex);
+        agingStep = step;
+    }
+
+    array<DeadlineStats, PRIORITY_CLASSES> Deadlines() {
+        lock_guard<mutex> lock(listMutex);
+        return deadlineStats;
+    }
+
+    string DeadlineReport() { return FormatDeadlines(Deadlines()); }
+
+    LatenessHistogram Lateness() {
+        lock_guard<mutex> lock(listMutex);
+        return lateness;
+    }
+
+    void ResetLateness() {
+        lock_guard<mutex> lock(listMutex);
+        lateness = LatenessHistogram();
+    }
+
+    // 彻ִ (첽ɻصЭָ̻). ֹͣ: fn ,
+    // ЭݴȡЭ, й©Э֡
+    void Post(function<void()> fn) {
+        {
+            lock_guard<mutex> lock(listMutex);
+            if (!running) return;
+            executor->Submit(move(fn));
+        }
+    }
+
+    //  at ʱ̰彻ִ; ֹͣʱδڵͬ
+    void PostAt(SchedClock::time_point at, function<void()> fn) {
+        {
+            lock_guard<mutex> lock(listMutex);
+            if (!running) return;
+            wakeups.push({ at, wakeupSeq++, move(fn) });
+        }
+        cv.notify_all();
+    }
+
+    // ־û opts.dir еĿ + ־βؽ. ֮ǰ;
+    // factory  kind ´,  nullptr ļ¼. ״̬־û, ָ²
+    bool EnablePersistence(const PersistOptions& opts, function<shared_ptr<ITask>(int kind)> factory) {
+        auto t0 = chrono::steady_clock::now();
+        {
+            lock_guard<mutex> lock(listMutex);
+            if (wal || !timers->Empty() || !ready.Empty() || !quarantined.empty()) {
+                Log("Persistence must be enabled before any task is added.");
+                return false;
+            }
+        }
+
+        TaskWal::State state;
+        unique_ptr<TaskWal> log;
+        try {
+            state = TaskWal::Load(opts.dir);
+            log = make_unique<TaskWal>(opts.dir, state.gen + 1, opts.commitInterval, opts.snapshotEvery);
+        }
+        catch (const exception& e) {
+            Log(string("Persistence disabled: ") + e.what());
+            return false;
+        }
+
+        // ⴴ
+        auto now = SchedClock::now();
+        int64_t wallOffset = WallOffsetUs();
+        vector<shared_ptr<ScheduledTask>> restored;
+        restored.reserve(state.tasks.size());
+        size_t missed = 0, dropped = 0;
+        for (const auto& r : state.tasks) {
+            auto task = r.kind ? factory(r.kind) : nullptr;
+            if (!task) { ++dropped; continue; }
+            auto st = make_shared<ScheduledTask>();
+            st->id = r.id;
+            st->kind = r.kind;
+            st->task = move(task);
+            st->runTime = SchedClock::time_point(chrono::duration_cast<SchedClock::duration>(chrono::microseconds(r.runTimeUs - wallOffset)));
+            st->interval = chrono::milliseconds(r.intervalMs);
+            st->isPeriodic = r.intervalMs > 0;
+            st->mode = (r.flags & 1) ? PeriodMode::FixedRate : PeriodMode::FixedDelay;
+            st->overrun = (MissedRunPolicy)min<uint32_t>((r.flags >> 1) & 3, (uint32_t)MissedRunPolicy::Skip);
+            st->maxCatchUp = max(1, (int)(r.flags >> 16));
+            st->relDeadline = chrono::milliseconds(max(0, r.deadlineMs));
+            st->priority = (TaskPriority)min(max(0, r.priority), PRIORITY_CLASSES - 1);
+            st->nominal = st->runTime;
+            if (st->runTime < now) {
+                ++missed;
+                if (!ApplyMissedRun(*st, now, opts)) { ++dropped; continue; }
+            }
+            restored.push_back(move(st));
+        }
+
+        {
+            lock_guard<mutex> lock(listMutex);
+            persist = opts;
+            nextId = max(nextId, state.nextId);
+            timers->PushAll(restored);
+            JournalReset();
+            wal = move(log);
+            // Իָ״̬ʼһ־, ־ڿ̺ɾ
+            active.clear();
+            vector<TaskRecord> records;
+            records.reserve(timers->Size());
+            timers->ForEach([&](const shared_ptr<ScheduledTask>& t) { records.push_back(ToRecord(*t, wallOffset)); });
+            wal->WriteSnapshot(move(records), nextId);
+        }
+        cv.notify_all();
+
+        auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - t0).count();
+        static const char* POLICY_NAMES[] = { "fire once", "fire all", "skip" };
+        string msg = "Recovered " + to_string(restored.size()) + " task(s) from " + opts.dir + " in " + to_string(ms) + " ms";
+        msg += " (" + to_string(state.replayed) + " log records, " + to_string(missed) + " missed -> " + POLICY_NAMES[(int)opts.missedRuns];
+        if (dropped) msg += ", " + to_string(dropped) + " dropped";
+        if (state.tornBytes) msg += ", " + to_string(state.tornBytes) + " torn bytes discarded";
+        Log(msg + ").");
+        RefreshUI();
+        return true;
+    }
+
+    // kind  0 ѿ־ûʱ, дԤд־, ɹ kind ؽ
+    void AddTask(const TaskSpec& spec) {
+        auto st = MakeEntry(spec, SchedClock::now());
+        uint64_t seq = 0;
+        { lock_guard<mutex> lock(listMutex); st->id = nextId++; seq = Enqueue(st); }
+        cv.notify_all();
+        WaitCommitted(seq);
+        Log("Added: " + spec.task->GetName());
+        RefreshUI();
+    }
+
+    // : ⹹Ŀ, һμȫ, ֻ֪ͨ־ˢ½һ.
+    //  id , صһ id (specs Ϊʱ 0)
+    int AddTasks(const vector<TaskSpec>& specs) {
+        if (specs.empty()) return 0;
+        auto now = SchedClock::now();
+        vector<shared_ptr<ScheduledTask>> batch;
+        batch.reserve(specs.size());
+        for (const auto& spec : specs) batch.push_back(MakeEntry(spec, now));
+
+        int firstId;
+        uint64_t seq = 0;
+        {
+            lock_guard<mutex> lock(listMutex);
+            firstId = nextId;
+            for (auto& st : batch) st->id = nextId++;
+            timers->PushAll(batch);
+            // ־ʱ, ýҳȡ¼ʡ
+            if (batch.size() > JOURNAL_LIMIT) JournalReset();
+            else for (const auto& st : batch) Journal(PendingOp::Upsert, st->id);
+            if (wal && running) {
+                vector<TaskRecord> records;
+                int64_t offset = WallOffsetUs();
+                for (const auto& st : batch) if (st->kind) records.push_back(ToRecord(*st, offset));
+                if (!records.empty()) {
+                    seq = wal->UpsertAll(records);
+                    MaybeSnapshot();
+                }
+            }
+        }
+        cv.notify_all();
+        WaitCommitted(seq);
+        Log("Added " + to_string(batch.size()) + " task(s) in one batch (ids " + to_string(firstId) + "-" + to_string(firstId + (int)batch.size() - 1) + ").");
+        RefreshUI();
+        return firstId;
+    }
+
+    void AddTask(shared_ptr<ITask> task, int delayMs, int intervalMs = 0, int kind = 0) {
+        TaskSpec spec;
+        spec.task = move(task);
+        spec.delayMs = delayMs;
+        spec.intervalMs = intervalMs;
+        spec.kind = kind;
+        AddTask(spec);
+    }
+
+    // ִֻܳ () ; ִеڶ,  false
+    bool RevokeTask(int taskId) {
+        shared_ptr<ScheduledTask> st;
+        uint64_t seq = 0;
+        {
+            lock_guard<mutex> lock(listMutex);
+            st = timers->Remove(taskId);
+            if (!st) st = ready.Remove(taskId);
+            if (st) CountUnrun(*st, SchedClock::now());
+            if (!st) {
+                auto it = quarantined.find(taskId);
+                if (it != quarantined.end()) { st = it->second; quarantined.erase(it); }
+            }
+            if (!st) return false;
+            Journal(PendingOp::Remove, taskId);
+            seq = Retire(*st);
+        }
+        WaitCommitted(seq);
+        Log("Revoked: " + st->task->GetName());
+        RefreshUI();
+        return true;
+    }
+
+    void ClearAllTasks() {
+        uint64_t seq = 0;
+        {
+            lock_guard<mutex> lock(listMutex);
+            timers->Clear();
+            ready.Clear();
+            quarantined.clear();
+            JournalReset();
+            if (wal && running) {
+                active.clear();
+                seq = wal->Clear();
+            }
+        }
+        WaitCommitted(seq);
+        Log("Queue cleared (All pending tasks removed).");
+        RefreshUI();
+    }
+
+    uint64_t PendingVersion() {
+        lock_guard<mutex> lock(listMutex);
+        return pendingVersion;
+    }
+
+    // 洦һ WM_UPDATE_LIST , ٴͶ
+    void ListRefreshed() { refreshQueued = false; }
+
+    //  (runTime, id) ĵ [offset, offset + limit) , е
+    PendingPage QueryPending(size_t offset, size_t limit) {
+        PendingPage page;
+        vector<RowKey> keys;
+        {
+            lock_guard<mutex> lock(listMutex);
+            page.version = pendingVersion;
+            keys.reserve(timers->Size() + ready.Size() + quarantined.size());
+            auto add = [&](const shared_ptr<ScheduledTask>& t) { keys.push_back({ t->id, t->runTime, t->isPeriodic, false, t->priority }); };
+            timers->ForEach(add);
+            ready.ForEach(add);
+            for (const auto& kv : quarantined) keys.push_back({ kv.first, kv.second->runTime, kv.second->isPeriodic, true, kv.second->priority });
+        }
+        page.total = keys.size();
+        if (offset >= keys.size()) return page;
+        size_t end = min(keys.size(), offset + limit);
+        partial_sort(keys.begin(), keys.begin() + end, keys.end(), RowLess);
+        page.rows = FormatRows(vector<RowKey>(keys.begin() + offset, keys.begin() + end));
+        return page;
+    }
+
+    //  sinceVersion ı; ͬһ id ĶαϲΪһ
+    PendingDelta QueryPendingSince(uint64_t sinceVersion) {
+        PendingDelta delta;
+        vector<RowKey> keys;
+        {
+            lock_guard<mutex> lock(listMutex);
+            delta.version = pendingVersion;
+            delta.total = timers->Size() + ready.Size() + quarantined.size();
+            if (sinceVersion >= pendingVersion) return delta;
+            if (sinceVersion < resyncBefore || journal.empty() || journal.front().version > sinceVersion + 1) {
+                delta.fullResync = true;
+                return delta;
+            }
+            unordered_map<int, PendingOp> last;
+            for (auto it = journal.rbegin(); it != journal.rend() && it->version > sinceVersion; ++it)
+                last.emplace(it->id, it->op);
+            for (const auto& kv : last) {
+                bool q;
+                auto st = kv.second == PendingOp::Upsert ? FindPending(kv.first, q) : nullptr;
+                if (st) keys.push_back({ st->id, st->runTime, st->isPeriodic, q, st->priority });
+                else delta.removed.push_back(kv.first);
+            }
+        }
+        sort(keys.begin(), keys.end(), RowLess);
+        delta.upserts = FormatRows(keys);
+        return delta;
+    }
+};
+
+// ==========================================
+// Э
+// ==========================================
+// Эķ:  ( CoroutineTask::Start ״λָ), ʱ֡ٲ done.
+class CoTask {
+public:
+    struct promise_type {
+        TaskDone done;
+        exception_ptr error;
+
+        CoTask get_return_object() { return CoTask(coroutine_handle<promise_type>::from_promise(*this)); }
+        suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(coroutine_handle<promise_type> h) noexcept {
+                TaskDone done = move(h.promise().done);
+                exception_ptr error = h.promise().error;
+                h.destroy();
+                if (!done) return;
+                if (!error) { done(false, string()); return; }
+                try { rethrow_exception(error); }
+                catch (const std::exception& e) { done(true, e.what()); }
+                catch (...) { done(true, "unknown exception"); }
+            }
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { error = current_exception(); }
+    };
+
+    CoTask(CoTask&& o) noexcept : h(exchange(o.h, nullptr)) {}
+    CoTask(const CoTask&) = delete;
+    ~CoTask() { if (h) h.destroy(); }
+
+    // Э̾, ֮ɾĳ߸ָ
+    coroutine_handle<promise_type> Release() { return exchange(h, nullptr); }
+
+private:
+    explicit CoTask(coroutine_handle<promise_type> handle) : h(handle) {}
+    coroutine_handle<promise_type> h;
+};
+
+// Э̰: ʵ Run(),  co_await ĵȴ. ڼ䲻ռ worker,
+// ָ TaskScheduler ִ (ܻһ worker). Եͨ ITask.
+class CoroutineTask : public ITask {
+public:
+    virtual CoTask Run() = 0;
+
+    void Execute() override {
+        promise<string> result;
+        Start([&](bool failed, const string& error) { result.set_value(failed ? error : string()); });
+        string error = result.get_future().get();
+        if (!error.empty()) throw runtime_error(error);
+    }
+
+    void Start(TaskDone done) override {
+        auto h = Run().Release();
+        h.promise().done = move(done);
+        h.resume();
+    }
+};
+
+// ָЭ̵, ɱ function<void()>. ֹͣʱûִоͱ
+// (Post ܾʱлִб); һݿʱδָ,  cancelled ָЭ:
+// ȴ await_resume 漴׳, Э֡ճչ, ʧܵ done.
+class Resumption {
+    struct State {
+        coroutine_handle<> h;
+        bool* cancelled;
+        ~State() {
+            if (!h) return;
+            *cancelled = true;
+            h.resume();
+        }
+    };
+    shared_ptr<State> state;
+
+public:
+    Resumption(coroutine_handle<> h, bool& cancelled) : state(new State{ h, &cancelled }) {}
+    void operator()() const { exchange(state->h, nullptr).resume(); }
+};
+
+static void ThrowIfCancelled(bool cancelled) {
+    if (cancelled) throw runtime_error("scheduler stopped before the task could resume");
+}
+
+// ļȡ I/O ר̳߳,  worker ֿ
+static WorkStealingExecutor& IoExecutor() {
+    static WorkStealingExecutor io(4);
+    return io;
+}
+
+// co_await SleepFor(ms): ںɵָ
+struct SleepFor {
+    SchedClock::time_point at;
+    bool cancelled = false;
+
+    explicit SleepFor(chrono::milliseconds d) : at(SchedClock::now() + d) {}
+    bool await_ready() const { return at <= SchedClock::now(); }
+    void await_suspend(coroutine_handle<> h) { TaskScheduler::Instance().PostAt(at, Resumption(h, cancelled)); }
+    void await_resume() const { ThrowIfCancelled(cancelled); }
+};
+
+// co_await ReadFileAsync(path):  I/O ̳߳ضļ, ɺɵָ; ʧʱ׳
+struct ReadFileAsync {
+    fs::path path;
+    vector<uint8_t> data;
+    string error;
+    bool cancelled = false;
+
+    explicit ReadFileAsync(fs::path p) : path(move(p)) {}
+    bool await_ready() const { return false; }
+    void await_suspend(coroutine_handle<> h) {
+        IoExecutor().Submit([this, resume = Resumption(h, cancelled)] {
+            try {
+                ifstream in(path, ios::binary);
+                if (!in) throw runtime_error("cannot open " + path.string());
+                data.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+            }
+            catch (const std::exception& e) { error = e.what(); }
+            TaskScheduler::Instance().Post(resume);
+        });
+    }
+    vector<uint8_t> await_resume() {
+        ThrowIfCancelled(cancelled);
+        if (!error.empty()) throw runtime_error(error);
+        return move(data);
+    }
+};
+
+struct ProcessResult {
+    bool failed = false;
+    string error;
+};
 
-public:
-    static TaskScheduler& Instance() { static TaskScheduler i; return i; }
-    ~TaskScheduler() { Stop(); }
+// co_await RunProcess(label, cmd, timeout): ӽ˳ʱָ, д־
+struct RunProcess {
+    shared_ptr<TaskProcess> proc;
+    ProcessResult result;
+    bool cancelled = false;
 
-    void Stop() {
-        { lock_guard<mutex> lock(listMutex); running = false; isFrozen = false; }
-        cv.notify_all();
-        if (workerThread.joinable()) workerThread.join();
+    RunProcess(string label, string cmd, uint32_t timeoutMs = 60000) : proc(make_shared<TaskProcess>(move(label), move(cmd), timeoutMs)) {}
+    bool await_ready() const { return false; }
+    void await_suspend(coroutine_handle<> h) {
+        proc->Start([this, resume = Resumption(h, cancelled)](bool failed, const string& error) {
+            result = { failed, error };
+            TaskScheduler::Instance().Post(resume);
+        });
     }
-
-    void UnfreezeSystem() {
-        {
-            lock_guard<mutex> lock(listMutex);
-            if (!isFrozen) { Log("System normal."); return; }
-            isFrozen = false;
-        }
-        Log("-> RESET Signal Received.");
-        cv.notify_all();
+    ProcessResult await_resume() const {
+        ThrowIfCancelled(cancelled);
+        return result;
     }
+};
 
-    void AddTask(shared_ptr<ITask> task, int delayMs, int intervalMs = 0) {
-        auto st = make_shared<ScheduledTask>();
-        st->id = nextId++;
-        st->task = task;
-        st->runTime = chrono::system_clock::now() + chrono::milliseconds(delayMs);
-        st->interval = chrono::milliseconds(intervalMs);
-        st->isPeriodic = (intervalMs > 0);
-        { lock_guard<mutex> lock(listMutex); taskList.push_back(st); }
-        cv.notify_one();
-        Log("Added: " + task->GetName());
-        RefreshUI();
+// co_await HttpGetAsync(url, timeout):  HttpCache , Ӧָ
+struct HttpGetAsync {
+    string url;
+    chrono::milliseconds timeout;
+    HttpResponse response;
+    bool cancelled = false;
+
+    HttpGetAsync(string u, chrono::milliseconds t) : url(move(u)), timeout(t) {}
+    bool await_ready() const { return false; }
+    void await_suspend(coroutine_handle<> h) {
+        HttpCache::Instance().Get(url, timeout, [this, resume = Resumption(h, cancelled)](HttpResponse& r) {
+            response = move(r);
+            TaskScheduler::Instance().Post(resume);
+        });
+    }
+    HttpResponse await_resume() {
+        ThrowIfCancelled(cancelled);
+        return move(response);
     }
+};
 
-    void RevokeTask(int taskId) {
-        lock_guard<mutex> lock(listMutex);
-        auto it = find_if(taskList.begin(), taskList.end(), [taskId](const auto& t) { return t->id == taskId; });
-        if (it != taskList.end()) {
-            string name = (*it)->task->GetName();
-            taskList.erase(it);
-            Log("Revoked: " + name);
-            RefreshUI();
+// co_await HttpGetAllAsync(urls, timeout): ȫ URL, һӦָ;  urls һһӦ
+struct HttpGetAllAsync {
+    vector<string> urls;
+    chrono::milliseconds timeout;
+    vector<HttpResponse> responses;
+    bool cancelled = false;
+
+    HttpGetAllAsync(vector<string> u, chrono::milliseconds t) : urls(move(u)), timeout(t), responses(urls.size()) {}
+    bool await_ready() const { return urls.empty(); }
+    void await_suspend(coroutine_handle<> h) {
+        auto left = make_shared<atomic<size_t>>(urls.size());
+        Resumption resume(h, cancelled);
+        for (size_t i = 0; i < urls.size(); ++i) {
+            HttpCache::Instance().Get(urls[i], timeout, [this, i, left, resume](HttpResponse& r) {
+                responses[i] = move(r);
+                if (--*left == 0) TaskScheduler::Instance().Post(resume);
+            });
         }
     }
+    vector<HttpResponse> await_resume() {
+        ThrowIfCancelled(cancelled);
+        return move(responses);
+    }
+};
 
-    void ClearAllTasks() {
-        {
-            lock_guard<mutex> lock(listMutex);
-            taskList.clear();
+// --- Task C: HTTP ---
+// ѯһ˵, ȫغ;  HttpCache ,  HttpClient ¼ѭ.
+// Эʵ: ȴӦԼռ worker. ʧܻ 5xx Ķ˵ retryDelay 󵥶һ
+class TaskHttp : public CoroutineTask {
+    vector<string> urls;
+    chrono::milliseconds timeout;
+    chrono::milliseconds retryDelay;
+
+    static bool Ok(const HttpResponse& r) { return r.status >= 200 && r.status < 400; }
+    static bool Transient(const HttpResponse& r) { return r.status == 0 || r.status >= 500; }
+
+public:
+    explicit TaskHttp(vector<string> endpoints = { "http://example.com/" }, chrono::milliseconds t = chrono::milliseconds(5000),
+        chrono::milliseconds retry = chrono::milliseconds(1000))
+        : urls(move(endpoints)), timeout(t), retryDelay(retry) {}
+
+    string GetName() const override { return "Task C: HTTP GET"; }
+
+    CoTask Run() override {
+        Log("C: Requesting " + to_string(urls.size()) + " endpoint(s)...");
+        auto start = chrono::steady_clock::now();
+        vector<HttpResponse> rs = co_await HttpGetAllAsync(urls, timeout);
+
+        vector<size_t> again;
+        for (size_t i = 0; i < rs.size(); ++i)
+            if (!Ok(rs[i]) && Transient(rs[i])) again.push_back(i);
+        if (!again.empty() && retryDelay.count() > 0) {
+            Log("C: " + to_string(again.size()) + " endpoint(s) failed, retrying in " + to_string(retryDelay.count()) + " ms...");
+            co_await SleepFor(retryDelay);
+            vector<string> retryUrls;
+            for (size_t i : again) retryUrls.push_back(urls[i]);
+            vector<HttpResponse> second = co_await HttpGetAllAsync(move(retryUrls), timeout);
+            for (size_t k = 0; k < again.size(); ++k) rs[again[k]] = move(second[k]);
         }
-        Log("Queue cleared (All pending tasks removed).");
-        RefreshUI();
-    }
 
-    vector<pair<int, string>> GetPendingTasks() {
-        lock_guard<mutex> lock(listMutex);
-        vector<pair<int, string>> res;
-        for (const auto& t : taskList) {
-            stringstream ss;
-            ss << "[" << t->GetTimeStr() << "] " << t->task->GetName();
-            if (t->isPeriodic) ss << " (Loop)";
-            res.push_back({ t->id, ss.str() });
+        size_t ok = 0, unchanged = 0;
+        uint64_t bytes = 0;
+        vector<double> latency;
+        string firstError;
+        for (size_t i = 0; i < rs.size(); ++i) {
+            const HttpResponse& r = rs[i];
+            if (Ok(r)) {
+                ++ok;
+                // δ仯Ӧͳ /  body
+                if (r.notModified) ++unchanged;
+                else bytes += r.body.size();
+                latency.push_back(r.latencyMs);
+            }
+            else if (firstError.empty()) {
+                firstError = urls[i] + ": " + (r.status ? "HTTP " + to_string(r.status) : r.error);
+            }
         }
-        return res;
+        if (rs.empty()) co_return;
+
+        sort(latency.begin(), latency.end());
+        auto pct = [&](double q) { return latency.empty() ? 0.0 : latency[(size_t)(q * (latency.size() - 1))]; };
+        double total = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        ReportBuffer& msg = ReportBuffer::Begin();
+        HttpCacheStats cs = HttpCache::Instance().Stats();
+        msg.Text("C: Data received. ").UInt(ok).Text("/").UInt(rs.size()).Text(" ok (").UInt(unchanged).Text(" unchanged), ")
+            .Fixed(bytes / 1024.0, 1).Text(" KB, p50 ").Fixed(pct(0.50), 1).Text(" ms, p99 ").Fixed(pct(0.99), 1)
+            .Text(" ms, total ").Fixed(total, 1).Text(" ms. Cache: ").UInt(cs.hits).Text(" hit / ").UInt(cs.misses)
+            .Text(" miss, ").Fixed(cs.bytesSaved / 1024.0, 1).Text(" KB saved.");
+        Log(msg.Str());
+        if (!firstError.empty()) Log("C: First error: " + firstError);
+        if (ok == 0) throw runtime_error(firstError);
     }
 };
 
@@ -457,6 +6217,7 @@ public:
     static shared_ptr<ITask> CreateTask(int id) {
         switch (id) {
         case ID_BTN_A: return make_shared<TaskBackup>();
+        case ID_BTN_A_INCR: return make_shared<TaskBackup>(BackupMode::Incremental);
         case ID_BTN_B: return make_shared<TaskMatrix>();
         case ID_BTN_C: return make_shared<TaskHttp>();
         case ID_BTN_D: return make_shared<TaskReminder>();
@@ -465,13 +6226,111 @@ public:
         default: return nullptr;
         }
     }
+
+    // ־ûõ kind; ע񷵻 0, д־, ҲḴ
+    static int PersistKind(int id) {
+        switch (id) {
+        case ID_BTN_F: return 0;
+        default: return CreateTask(id) ? id : 0;
+        }
+    }
 };
 
+#ifdef SCHEDULER_GUI
 // ==========================================
 // UI Logic
 // ==========================================
+// б: ֻʾǰ PAGE_ROWS . ƽʱ QueryPendingSince ɾ / ;
+//  fullResync, ضϵҳɾֿȱ (Ҫδصĺвλ) ʱҳȡ.
+class PendingListView {
+    static constexpr size_t PAGE_ROWS = 500;
+    HWND hList = NULL;
+    bool loaded = false;
+    uint64_t version = 0;
+    size_t total = 0;
+    vector<PendingRow> rows;    // бǰ rows.size() һһӦ; total ʱĩβһ "... N more"
+
+    int SelectedId() const {
+        int sel = (int)SendMessageA(hList, LB_GETCURSEL, 0, 0);
+        return sel != LB_ERR ? (int)SendMessageA(hList, LB_GETITEMDATA, sel, 0) : 0;
+    }
+
+    void Insert(size_t idx, const PendingRow& r, int selId) {
+        int i = (int)SendMessageA(hList, LB_INSERTSTRING, idx, (LPARAM)r.text.c_str());
+        SendMessageA(hList, LB_SETITEMDATA, i, (LPARAM)r.id);
+        if (r.id == selId) SendMessageA(hList, LB_SETCURSEL, i, 0);
+        rows.insert(rows.begin() + idx, r);
+    }
+
+    void Erase(size_t idx) {
+        SendMessageA(hList, LB_DELETESTRING, idx, 0);
+        rows.erase(rows.begin() + idx);
+    }
+
+    void AddMoreLine() {
+        if (total <= rows.size()) return;
+        string more = "... " + to_string(total - rows.size()) + " more";
+        int idx = (int)SendMessageA(hList, LB_ADDSTRING, 0, (LPARAM)more.c_str());
+        SendMessageA(hList, LB_SETITEMDATA, idx, 0);
+    }
+
+    void Reload(TaskScheduler& sched, int selId) {
+        auto page = sched.QueryPending(0, PAGE_ROWS);
+        SendMessageA(hList, LB_RESETCONTENT, 0, 0);
+        rows.clear();
+        rows.reserve(page.rows.size());
+        for (const auto& r : page.rows) Insert(rows.size(), r, selId);
+        version = page.version;
+        total = page.total;
+        loaded = true;
+        AddMoreLine();
+    }
+
+    // Ӧ;  false ʾҳֿȱ, Ҫҳȡ
+    bool Apply(const PendingDelta& delta, int selId) {
+        bool complete = total <= rows.size();   // Ѽȫ, Ծȷλ
+        if (!complete) SendMessageA(hList, LB_DELETESTRING, rows.size(), 0);
+        PendingRow boundary = complete ? PendingRow() : rows.back();
+        auto drop = [&](int id) {
+            auto it = find_if(rows.begin(), rows.end(), [id](const PendingRow& r) { return r.id == id; });
+            if (it != rows.end()) Erase(it - rows.begin());
+        };
+        for (int id : delta.removed) drop(id);
+        for (const auto& r : delta.upserts) drop(r.id);
+        for (const auto& r : delta.upserts) {
+            // ضʱ, ԭһ֮λδ֪ (мδص)
+            if (!complete && !PendingRow::Less(r, boundary)) continue;
+            Insert(upper_bound(rows.begin(), rows.end(), r, PendingRow::Less) - rows.begin(), r, selId);
+        }
+        while (rows.size() > PAGE_ROWS) Erase(rows.size() - 1);
+        version = delta.version;
+        total = delta.total;
+        if (!complete && rows.size() < min(total, PAGE_ROWS)) return false;
+        AddMoreLine();
+        return true;
+    }
+
+public:
+    void Attach(HWND h) { hList = h; }
+
+    // 汾δ򲻶б
+    void Refresh(TaskScheduler& sched) {
+        if (loaded && sched.PendingVersion() == version) return;
+        int selId = SelectedId();
+        SendMessageA(hList, WM_SETREDRAW, FALSE, 0);
+        if (!loaded) Reload(sched, selId);
+        else {
+            PendingDelta delta = sched.QueryPendingSince(version);
+            if (delta.fullResync || !Apply(delta, selId)) Reload(sched, selId);
+        }
+        SendMessageA(hList, WM_SETREDRAW, TRUE, 0);
+        InvalidateRect(hList, NULL, TRUE);
+    }
+};
+
 LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
     static HWND hListTasks, hEditLog, hEditData;
+    static PendingListView taskList;
 
     switch (message) {
     case WM_CREATE:
@@ -520,13 +6379,14 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
         curY += 25;
 
-        auto Btn = [&](const char* txt, int id, int x, int w) {
+        auto Btn = [&](const char* txt, int id, int x, int w, bool rowEnd = true) {
             HWND hBtn = CreateWindowA("BUTTON", txt, WS_VISIBLE | WS_CHILD | BS_PUSHBUTTON, x, curY, w, btnH, hWnd, (HMENU)(UINT_PTR)id, NULL, NULL);
             SendMessage(hBtn, WM_SETFONT, (WPARAM)hFontUI, TRUE);
-            curY += btnH + gap;
+            if (rowEnd) curY += btnH + gap;
             };
 
-        Btn("Task A: Backup (Disk)", ID_BTN_A, col1_x + 10, col1_w - 20);
+        Btn("Task A: Backup (Zip)", ID_BTN_A, col1_x + 10, 125, false);
+        Btn("Incremental", ID_BTN_A_INCR, col1_x + 140, col1_w - 150);
         Btn("Task B: Matrix (Visual)", ID_BTN_B, col1_x + 10, col1_w - 20);
         Btn("Task C: HTTP GET", ID_BTN_C, col1_x + 10, col1_w - 20);
         Btn("Task D: Reminder", ID_BTN_D, col1_x + 10, col1_w - 20);
@@ -554,6 +6414,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         hListTasks = CreateWindowA("LISTBOX", "", WS_VISIBLE | WS_CHILD | WS_BORDER | WS_VSCROLL | LBS_NOTIFY | LBS_NOINTEGRALHEIGHT,
             col2_x, midY, col2_w, hQueue, hWnd, (HMENU)(UINT_PTR)ID_LIST_TASKS, NULL, NULL);
         SendMessage(hListTasks, WM_SETFONT, (WPARAM)hFontUI, TRUE);
+        taskList.Attach(hListTasks);
         midY += hQueue + gap;
 
         int smallBtnW = (col2_w - 10) / 2;
@@ -601,6 +6462,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             col3_x, rightY, col3_w, rightEditH, hWnd, (HMENU)(UINT_PTR)ID_EDIT_DATA, NULL, NULL);
         SendMessage(hEditData, WM_SETFONT, (WPARAM)hFontLog, TRUE);
         SendMessageA(hEditData, EM_SETLIMITTEXT, 0x7FFFFFFF, 0);
+
+        static EditControlSink sink(hEditLog, hEditData);
+        sink.Reset(SinkChannelId::Data, "Waiting for data tasks (B or E)...\r\n");
+        g_sink = &sink;
+        SetTimer(hWnd, ID_TIMER_SINK, SINK_REFRESH_MS, NULL);
     }
     break;
 
@@ -633,11 +6499,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         int id = LOWORD(wParam);
 
         if (id == ID_BTN_CLEAR_LOG) {
-            SetWindowTextA(hEditLog, "");
+            if (OutputSink* sink = g_sink.load()) sink->Reset(SinkChannelId::Log, "");
             return 0;
         }
         if (id == ID_BTN_CLEAR_DATA) {
-            SetWindowTextA(hEditData, "Waiting for data tasks (B or E)...\r\n");
+            if (OutputSink* sink = g_sink.load()) sink->Reset(SinkChannelId::Data, "Waiting for data tasks (B or E)...\r\n");
             return 0;
         }
 
@@ -650,7 +6516,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             int sel = (int)SendMessageA(hListTasks, LB_GETCURSEL, 0, 0);
             if (sel != LB_ERR) {
                 int tid = (int)SendMessageA(hListTasks, LB_GETITEMDATA, sel, 0);
-                TaskScheduler::Instance().RevokeTask(tid);
+                if (!TaskScheduler::Instance().RevokeTask(tid)) Log("Revoke skipped: task is running, try again when it is back in the queue.");
             }
             return 0;
         }
@@ -662,58 +6528,39 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
         auto task = TaskFactory::CreateTask(id);
         if (task) {
-            int delay = 0, interval = 0;
+            TaskSpec spec;
+            spec.task = task;
+            spec.kind = TaskFactory::PersistKind(id);
             switch (id) {
-            case ID_BTN_A: delay = 1000; break;
-            case ID_BTN_B: interval = 5000; break;
-            case ID_BTN_C: delay = 0; break;
-            case ID_BTN_D: interval = 60000; break;
-            case ID_BTN_E: delay = 5000; break;
-            case ID_BTN_F: delay = 500; break;
+            case ID_BTN_A:
+            case ID_BTN_A_INCR: spec.delayMs = 1000; spec.priority = TaskPriority::Low; break;
+            case ID_BTN_B: spec.intervalMs = 5000; spec.mode = PeriodMode::FixedRate; break;
+            case ID_BTN_C: spec.delayMs = 0; break;
+            case ID_BTN_D: spec.intervalMs = 60000; spec.mode = PeriodMode::FixedRate; spec.priority = TaskPriority::High; spec.deadlineMs = 1000; break;
+            case ID_BTN_E: spec.delayMs = 5000; break;
+            case ID_BTN_F: spec.delayMs = 500; break;
             }
-            TaskScheduler::Instance().AddTask(task, delay, interval);
-        }
-    }
-    break;
-
-    case WM_UPDATE_LOG:
-    {
-        string* s = (string*)lParam;
-        if (s) {
-            int len = GetWindowTextLengthA(hEditLog);
-            SendMessageA(hEditLog, EM_SETSEL, (WPARAM)len, (LPARAM)len);
-            SendMessageA(hEditLog, EM_REPLACESEL, 0, (LPARAM)s->c_str());
-            SendMessageA(hEditLog, EM_REPLACESEL, 0, (LPARAM)"\r\n");
-            delete s;
+            TaskScheduler::Instance().AddTask(spec);
         }
     }
     break;
 
-    case WM_UPDATE_DATA:
+    case WM_TIMER:
     {
-        string* s = (string*)lParam;
-        if (s) {
-            int len = GetWindowTextLengthA(hEditData);
-            SendMessageA(hEditData, EM_SETSEL, (WPARAM)len, (LPARAM)len);
-            SendMessageA(hEditData, EM_REPLACESEL, 0, (LPARAM)s->c_str());
-            SendMessage(hEditData, WM_VSCROLL, SB_BOTTOM, 0);
-            delete s;
+        if (wParam == ID_TIMER_SINK) {
+            if (OutputSink* sink = g_sink.load()) sink->Flush();
         }
     }
     break;
 
     case WM_UPDATE_LIST:
-    {
-        SendMessageA(hListTasks, LB_RESETCONTENT, 0, 0);
-        auto list = TaskScheduler::Instance().GetPendingTasks();
-        for (const auto& p : list) {
-            int idx = (int)SendMessageA(hListTasks, LB_ADDSTRING, 0, (LPARAM)p.second.c_str());
-            SendMessageA(hListTasks, LB_SETITEMDATA, idx, (LPARAM)p.first);
-        }
-    }
-    break;
+        TaskScheduler::Instance().ListRefreshed();
+        taskList.Refresh(TaskScheduler::Instance());
+        break;
 
     case WM_DESTROY:
+        KillTimer(hWnd, ID_TIMER_SINK);
+        g_sink = nullptr;
         DeleteObject(hFontUI);
         DeleteObject(hFontBold);
         DeleteObject(hFontLog);
@@ -733,6 +6580,16 @@ int APIENTRY WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     hGlobalWnd = CreateWindowA("SchClass", "Project 3: Scheduler w/ Data Visualization Board", WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX,
         50, 50, 1350, 760, NULL, NULL, hInstance, NULL);
 
+    TimerPrecision precision;
+    precision.highResolution = true;
+    precision.spin = chrono::microseconds(200);
+    TaskScheduler::Instance().SetTimerPrecision(precision);
+
+    // ؽϴ˳ () ǰĴִ, ťż kind; ־ĹעֱӶ
+    TaskScheduler::Instance().EnablePersistence(PersistOptions(), [](int kind) {
+        return TaskFactory::PersistKind(kind) ? TaskFactory::CreateTask(kind) : nullptr;
+    });
+
     ShowWindow(hGlobalWnd, SW_SHOW);
     UpdateWindow(hGlobalWnd);
 
@@ -742,4 +6599,1015 @@ int APIENTRY WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
         DispatchMessageA(&msg);
     }
     return 0;
-}
\ No newline at end of file
+}
+#endif
+#ifndef SCHEDULER_GUI
+// ==========================================
+// ޽
+// ==========================================
+// Linux:   g++ -std=c++20 -O2 -pthread WindowsProject1.cpp -o scheduler   ( -march=native  AVX2 / SSE4.2 ·)
+//          ټ -DSCHEDULER_BENCH ׼
+// Windows: cl /std:c++20 /O2 /EHsc /DSCHEDULER_BENCH WindowsProject1.cpp  (̨, , ׼)
+// ÷: scheduler [--seconds N] TASK...   TASK Ϊ A-F (ͬ水ť, A+ Ϊ), ɸ @ӳms  /ms,  B@500 E@0/1000
+//       G[@ӳms][/ms]: ⲿ (Windows Ϊ CreateProcess , ϵͳ /bin/sh -c),  "G/5000:ls -l"
+// ־ stdout,  N  (Ĭ 10) ˳. ѵ Windows .
+//       scheduler bench [NAME...] [--quick]   ׼ ( SCHEDULER_BENCH), 
+class ConsoleSink : public OutputSink {
+protected:
+    void Present(SinkChannelId ch, const string& text, size_t) override {
+        string out;
+        out.reserve(text.size() + 1);
+        for (char c : text) if (c != '\r') out += c;
+        if (ch == SinkChannelId::Data && !out.empty() && out.back() != '\n') out += '\n';
+        fwrite(out.data(), 1, out.size(), stdout);
+        fflush(stdout);
+    }
+    void Replace(SinkChannelId, const string&) override {}
+};
+
+static bool ParseTaskArg(const string& arg, TaskSpec& spec) {
+    if (arg.empty() || arg[0] < 'A' || arg[0] > 'G') return false;
+    int id = ID_BTN_A + (arg[0] - 'A');
+    size_t pos = 1;
+    if (arg.compare(0, 2, "A+") == 0) { id = ID_BTN_A_INCR; pos = 2; }
+    auto number = [&](int& out) {
+        auto r = from_chars(arg.data() + pos + 1, arg.data() + arg.size(), out);
+        if (r.ec != errc()) return false;
+        pos = r.ptr - arg.data();
+        return true;
+    };
+    if (pos < arg.size() && arg[pos] == '@' && !number(spec.delayMs)) return false;
+    if (pos < arg.size() && arg[pos] == '/' && !number(spec.intervalMs)) return false;
+    // G ûаť: ðźζ
+    if (arg[0] == 'G') {
+        if (pos + 1 >= arg.size() || arg[pos] != ':') return false;
+        string cmd = arg.substr(pos + 1);
+        spec.task = make_shared<TaskProcess>(cmd, cmd);
+        return true;
+    }
+    spec.task = TaskFactory::CreateTask(id);
+    return spec.task && pos == arg.size();
+}
+
+#ifdef SCHEDULER_BENCH
+// ------------------------------------------
+// ׼: scheduler bench [NAME...] [--quick]
+// ------------------------------------------
+// ֱģ (), ӡ stdout.  NAME ʱȫ, --quick Сģ, ð.
+
+// : ֻͳƵ̵߳ operator new ,  "ÿݱ伸". ֻڻ׼Թ滻ȫ new.
+// delete  volatile ָ free:  operator new  free, 󱨲
+static thread_local uint64_t t_benchAllocs = 0;
+static void (*volatile benchFree)(void*) = free;
+
+void* operator new(size_t n) {
+    ++t_benchAllocs;
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { benchFree(p); }
+void operator delete(void* p, size_t) noexcept { benchFree(p); }
+
+using BenchClock = chrono::steady_clock;
+
+static double BenchSeconds(BenchClock::time_point since) {
+    return chrono::duration<double>(BenchClock::now() - since).count();
+}
+
+// λ (q ȡ 0..1),  v 
+static double BenchPercentile(vector<double>& v, double q) {
+    if (v.empty()) return 0;
+    sort(v.begin(), v.end());
+    size_t rank = (size_t)ceil(q * (double)v.size());
+    return v[min(v.size() - 1, rank ? rank - 1 : 0)];
+}
+
+// ִи, ʹ
+class BenchTask : public ITask {
+    string name;
+    function<void()> fn;
+public:
+    BenchTask(string name, function<void()> fn) : name(move(name)), fn(move(fn)) {}
+    string GetName() const override { return name; }
+    void Execute() override { fn(); }
+};
+
+// ִʱʧ, ԵصΪֹ
+static void BenchRevoke(int id) {
+    while (!TaskScheduler::Instance().RevokeTask(id)) this_thread::sleep_for(chrono::milliseconds(1));
+}
+
+static void BenchBusy(chrono::microseconds d) {
+    auto end = BenchClock::now() + d;
+    while (BenchClock::now() < end) {}
+}
+
+// ػ HTTP : ߳ poll, ֧ keep-alive ˮ,  200 ̶СӦ.
+// ÿӦ ETag "v1";  If-None-Match: "v1" ʱ 304, Ӧ.
+class LoopbackHttpServer {
+    struct Client {
+        NetSocket fd;
+        string in, out;
+        bool closed = false;
+    };
+
+    NetSocket listener = NET_INVALID;
+    string body;
+    int port = 0;
+    atomic<bool> stopping{ false };
+    thread loop;
+
+    void Serve(Client& c) {
+        size_t end;
+        while ((end = c.in.find("\r\n\r\n")) != string::npos) {
+            bool cached = string_view(c.in).substr(0, end).find("If-None-Match: \"v1\"") != string_view::npos;
+            c.in.erase(0, end + 4);
+            if (cached) {
+                c.out += "HTTP/1.1 304 Not Modified\r\nETag: \"v1\"\r\n\r\n";
+            }
+            else {
+                c.out += "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nETag: \"v1\"\r\nContent-Length: ";
+                c.out += to_string(body.size());
+                c.out += "\r\n\r\n";
+                c.out += body;
+            }
+        }
+    }
+
+    void Main() {
+        vector<Client> clients;
+        vector<pollfd> fds;
+        char buf[16384];
+        while (!stopping) {
+            fds.clear();
+            fds.push_back({ listener, POLLIN, 0 });
+            for (auto& c : clients) fds.push_back({ c.fd, (short)(POLLIN | (c.out.empty() ? 0 : POLLOUT)), 0 });
+            if (NetPoll(fds.data(), fds.size(), 50) <= 0) continue;
+            for (size_t i = 1; i < fds.size(); ++i) {
+                Client& c = clients[i - 1];
+                if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                    for (;;) {
+                        int n = (int)recv(c.fd, buf, sizeof(buf), 0);
+                        if (n > 0) { c.in.append(buf, (size_t)n); continue; }
+                        if (n == 0 || !NetWouldBlock()) c.closed = true;
+                        break;
+                    }
+                    Serve(c);
+                }
+                while (!c.closed && !c.out.empty()) {
+                    int n = (int)send(c.fd, c.out.data(), (int)min<size_t>(c.out.size(), 1 << 20), NET_SEND_FLAGS);
+                    if (n > 0) { c.out.erase(0, (size_t)n); continue; }
+                    if (!NetWouldBlock()) c.closed = true;
+                    break;
+                }
+            }
+            for (size_t i = 0; i < clients.size();) {
+                if (!clients[i].closed) { ++i; continue; }
+                NetClose(clients[i].fd);
+                clients[i] = move(clients.back());
+                clients.pop_back();
+            }
+            if (fds[0].revents & POLLIN) {
+                for (;;) {
+                    NetSocket s = accept(listener, nullptr, nullptr);
+                    if (s == NET_INVALID) break;
+                    NetNonBlocking(s);
+                    int one = 1;
+                    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+                    clients.push_back({ s, string(), string() });
+                }
+            }
+        }
+        for (auto& c : clients) NetClose(c.fd);
+    }
+
+public:
+    explicit LoopbackHttpServer(size_t bodyBytes) : body(bodyBytes, 'x') {
+        NetStartup();
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener == NET_INVALID) throw runtime_error("socket failed");
+        int one = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t len = sizeof(addr);
+        if (::bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 1024) != 0
+            || getsockname(listener, (sockaddr*)&addr, &len) != 0 || !NetNonBlocking(listener)) {
+            NetClose(listener);
+            throw runtime_error("cannot listen on loopback");
+        }
+        port = ntohs(addr.sin_port);
+        loop = thread(&LoopbackHttpServer::Main, this);
+    }
+
+    ~LoopbackHttpServer() {
+        stopping = true;
+        loop.join();
+        NetClose(listener);
+    }
+
+    string Url(const string& path) const { return "http://127.0.0.1:" + to_string(port) + path; }
+};
+
+// : ԭȵ, ɨ,  id Բҳ
+class LinearTimerStore : public ITimerStore {
+    vector<shared_ptr<ScheduledTask>> tasks;
+
+    static bool Less(const shared_ptr<ScheduledTask>& a, const shared_ptr<ScheduledTask>& b) {
+        return a->runTime != b->runTime ? a->runTime < b->runTime : a->id < b->id;
+    }
+    shared_ptr<ScheduledTask> Take(vector<shared_ptr<ScheduledTask>>::iterator it) {
+        auto st = move(*it);
+        *it = move(tasks.back());
+        tasks.pop_back();
+        return st;
+    }
+
+public:
+    bool Empty() const override { return tasks.empty(); }
+    size_t Size() const override { return tasks.size(); }
+    void Push(shared_ptr<ScheduledTask> st) override { tasks.push_back(move(st)); }
+    shared_ptr<ScheduledTask> PopDue(SchedClock::time_point now) override {
+        auto it = min_element(tasks.begin(), tasks.end(), Less);
+        if (it == tasks.end() || (*it)->runTime > now) return nullptr;
+        return Take(it);
+    }
+    SchedClock::time_point NextWakeup() const override { return (*min_element(tasks.begin(), tasks.end(), Less))->runTime; }
+    shared_ptr<ScheduledTask> Remove(int id) override {
+        auto it = find_if(tasks.begin(), tasks.end(), [id](const shared_ptr<ScheduledTask>& t) { return t->id == id; });
+        return it == tasks.end() ? nullptr : Take(it);
+    }
+    shared_ptr<ScheduledTask> Find(int id) const override {
+        auto it = find_if(tasks.begin(), tasks.end(), [id](const shared_ptr<ScheduledTask>& t) { return t->id == id; });
+        return it == tasks.end() ? nullptr : *it;
+    }
+    void Clear() override { tasks.clear(); }
+    void ForEach(const function<void(const shared_ptr<ScheduledTask>&)>& f) const override { for (auto& t : tasks) f(t); }
+    string GetName() const override { return "Linear scan (old)"; }
+};
+
+// --- heap: ʱ洢 ( / ʱ) ɷ / ִı仯, ͬһ ---
+// ѵıȽϴ log4(n) ; 洢ÿ³Ҫһηôδ
+// (heapIndex д, ʱ id ), Եοڲ. иÿ㿪빤С.
+static void BenchTimers(bool quick) {
+    printf("\n[heap] timer store cost per operation vs pending tasks\n");
+    printf("  dispatch = pop a due task and re-arm it; revoke = remove by id and add back\n");
+    printf("  heap compares grow with its levels (log4 n); ns/level rises once the store outgrows the CPU caches\n");
+    printf("  %9s  %-24s %8s %12s %12s %10s %10s\n", "pending", "store", "levels", "dispatch ns", "revoke ns", "ns/level", "store MB");
+    const size_t OPS = quick ? 50000 : 200000;
+    for (size_t n : { (size_t)1000, (size_t)10000, (size_t)100000, (size_t)1000000 }) {
+        if (quick && n > 100000) break;
+        int levels = 1;
+        for (size_t cap = 1; cap < n; cap = cap * 4 + 1) ++levels;
+        for (int kind = 0; kind < 3; ++kind) {
+            unique_ptr<ITimerStore> store;
+            if (kind == 1) store = make_unique<TimingWheel>();
+            else if (kind == 2) store = make_unique<LinearTimerStore>();
+            else store = make_unique<TaskHeap>();
+            // ɨÿ O(n), ģٴ, ܹԼ 2e8 αȽ
+            size_t ops = kind == 2 ? max<size_t>(100, min<size_t>(OPS, 200000000 / n)) : OPS;
+            FastRng rng(n * 2 + kind);
+            int span = (int)n; // ƽÿ뵽һ
+            auto base = SchedClock::now();
+            {
+                vector<shared_ptr<ScheduledTask>> all(n);
+                for (size_t i = 0; i < n; ++i) {
+                    all[i] = make_shared<ScheduledTask>();
+                    all[i]->id = (int)i + 1;
+                    all[i]->runTime = base + chrono::milliseconds(rng.UniformInt(1, span));
+                }
+                store->PushAll(all);
+            }
+
+            // ģʱÿǰ 1 ms, ȡȫ¼; һԤ
+            auto now = base;
+            auto dispatch = [&](size_t target) {
+                size_t done = 0;
+                while (done < target) {
+                    now += chrono::milliseconds(1);
+                    while (auto st = store->PopDue(now)) {
+                        st->runTime = now + chrono::milliseconds(rng.UniformInt(1, span));
+                        store->Push(move(st));
+                        ++done;
+                    }
+                }
+                return done;
+            };
+            dispatch(ops / 4);
+            auto t0 = BenchClock::now();
+            size_t done = dispatch(ops);
+            double dispatchNs = BenchSeconds(t0) * 1e9 / (double)done;
+
+            t0 = BenchClock::now();
+            for (size_t k = 0; k < ops; ++k) {
+                auto st = store->Remove(rng.UniformInt(1, (int)n));
+                store->Push(move(st));
+            }
+            double revokeNs = BenchSeconds(t0) * 1e9 / (double)ops;
+            double mb = n * (double)(sizeof(ScheduledTask) + 64) / 1048576.0; //  + λԼ
+            if (kind) printf("  %9zu  %-24s %8s %12.0f %12.0f %10s %10.1f\n", n, store->GetName().c_str(), "-", dispatchNs, revokeNs, "-", mb);
+            else printf("  %9zu  %-24s %8d %12.0f %12.0f %10.1f %10.1f\n", n, store->GetName().c_str(), levels, dispatchNs, revokeNs, dispatchNs / levels, mb);
+        }
+    }
+}
+
+// --- exec: CPU ܼ (Task B / Task E)  worker ı仯 ---
+static void BenchExecutor(bool quick) {
+    int hw = max(1, (int)thread::hardware_concurrency());
+    int jobs = quick ? 64 : 256;
+    printf("\n[exec] work-stealing executor, %d jobs of TaskMatrix(96, 1 thread) + TaskStats(200k), %d hardware thread(s)\n", jobs, hw);
+    printf("  %8s %12s %10s\n", "workers", "jobs/s", "scaling");
+    double base = 0;
+    for (int w = 1; w <= max(2, hw); w *= 2) {
+        atomic<int> left{ jobs };
+        mutex m;
+        condition_variable cv;
+        auto t0 = BenchClock::now();
+        {
+            WorkStealingExecutor ex(w);
+            for (int j = 0; j < jobs; ++j) {
+                shared_ptr<ITask> task = (j % 2) ? shared_ptr<ITask>(make_shared<TaskStats>(200000)) : make_shared<TaskMatrix>(96, 1);
+                ex.Submit([task, &left, &m, &cv] {
+                    task->Execute();
+                    if (--left == 0) { lock_guard<mutex> lk(m); cv.notify_all(); }
+                });
+            }
+            unique_lock<mutex> lk(m);
+            cv.wait(lk, [&] { return left == 0; });
+        }
+        double rate = jobs / BenchSeconds(t0);
+        if (w == 1) base = rate;
+        printf("  %8d %12.1f %9.2fx\n", w, rate, rate / base);
+    }
+}
+
+// --- log: 8 ̵߳ Log()  (д scheduler.log) ---
+static void BenchLog(bool quick) {
+    const int PRODUCERS = 8;
+    const int PER = quick ? 50000 : 250000;
+    printf("\n[log] Log() calls from %d producer threads, %d each\n", PRODUCERS, PER);
+    printf("  %-22s %14s %10s\n", "writer", "calls/s", "dropped");
+    LogWriter& w = LogWriter::Instance();
+    for (int variant = 0; variant < 3; ++variant) {
+        LogConfig cfg;
+        cfg.async = variant != 0;
+        if (variant == 2) cfg.overflow = LogOverflow::Drop;
+        w.Configure(cfg);
+        uint64_t dropped0 = w.DroppedCount();
+        auto t0 = BenchClock::now();
+        vector<thread> producers;
+        for (int p = 0; p < PRODUCERS; ++p)
+            producers.emplace_back([p, PER] {
+                string msg = "bench producer " + to_string(p) + " message ";
+                size_t keep = msg.size();
+                for (int i = 0; i < PER; ++i) {
+                    msg.resize(keep);
+                    msg += to_string(i);
+                    Log(msg);
+                }
+            });
+        for (auto& t : producers) t.join();
+        double secs = BenchSeconds(t0);
+        static const char* NAMES[] = { "sync (mutex + flush)", "async, block on full", "async, drop on full" };
+        printf("  %-22s %14.0f %10llu\n", NAMES[variant], PRODUCERS * (double)PER / secs, (unsigned long long)(w.DroppedCount() - dropped0));
+    }
+    w.Configure(LogConfig());
+}
+
+// --- sink: ޽ĺϲ޽ ---
+// 8 ߳, ģ涨ʱÿ SINK_REFRESH_MS ȡһ
+static void BenchSink(bool quick) {
+    const int PRODUCERS = 8;
+    const double SECONDS = quick ? 0.5 : 2.0;
+    printf("\n[sink] HeadlessSink, %d producers for %.1f s, flushed every %d ms\n", PRODUCERS, SECONDS, SINK_REFRESH_MS);
+    HeadlessSink sink;
+    atomic<bool> done{ false };
+    atomic<uint64_t> pushes{ 0 };
+    int flushes = 0;
+    double flushMs = 0, flushMaxMs = 0;
+    auto t0 = BenchClock::now();
+    vector<thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p)
+        producers.emplace_back([&, p] {
+            string msg = "worker " + to_string(p) + ": line ";
+            size_t keep = msg.size();
+            uint64_t i = 0;
+            for (; !done; ++i) {
+                msg.resize(keep);
+                msg += to_string(i);
+                sink.PushLog(msg);
+            }
+            pushes += i;
+        });
+    while (BenchSeconds(t0) < SECONDS) {
+        this_thread::sleep_for(chrono::milliseconds(SINK_REFRESH_MS));
+        auto f0 = BenchClock::now();
+        sink.Flush();
+        double ms = BenchSeconds(f0) * 1000.0;
+        flushMs += ms;
+        flushMaxMs = max(flushMaxMs, ms);
+        ++flushes;
+    }
+    done = true;
+    for (auto& t : producers) t.join();
+    double secs = BenchSeconds(t0);
+    sink.Flush();
+    const string& view = sink.View(SinkChannelId::Log);
+    printf("  %.0f pushes/s, %d flushes (avg %.2f ms, max %.2f ms), view bounded to %zu lines / %.1f KB\n",
+        pushes / secs, flushes, flushes ? flushMs / flushes : 0.0, flushMaxMs, (size_t)count(view.begin(), view.end(), '\n'), view.size() / 1024.0);
+}
+
+// --- gemm: ѭ, ֿں̷ֿ߳, N = 200 .. 4096 ---
+static void BenchGemm(bool quick) {
+    int hw = max(1, (int)thread::hardware_concurrency());
+    printf("\n[gemm] C = A x B, double, kernel %s, %d thread(s); naive rows are sampled when N is large (same per-row work)\n", GemmKernel::Isa(), hw);
+    printf("  %6s %14s %16s %16s %9s %9s\n", "N", "naive GFLOPS", "blocked GFLOPS", "parallel GFLOPS", "blk/naive", "par/blk");
+    FastRng rng(8);
+    for (int N : { 200, 512, 1024, 2048, 4096 }) {
+        if (quick && N > 1024) break;
+        AlignedMatrix A(N, N), B(N, N), C(N, N);
+        rng.FillReal(A.Data(), (size_t)N * N, 0.0, 10.0);
+        rng.FillReal(B.Data(), (size_t)N * N, 0.0, 10.0);
+
+        // ذֻǰ rows , Լ 2 GFLOP 
+        size_t rows = (size_t)min<double>(N, max(8.0, 2e9 / (2.0 * N * N)));
+        AlignedMatrix As(rows, N), Cs(rows, N);
+        memcpy(As.Data(), A.Data(), rows * N * sizeof(double));
+        auto t0 = BenchClock::now();
+        GemmKernel::MultiplyNaive(As, B, Cs);
+        double naive = 2.0 * rows * N * N / BenchSeconds(t0) / 1e9;
+
+        t0 = BenchClock::now();
+        GemmKernel::Multiply(A, B, C);
+        double blocked = 2.0 * N * N * N / BenchSeconds(t0) / 1e9;
+
+        t0 = BenchClock::now();
+        GemmKernel::MultiplyParallel(A, B, C, hw);
+        double parallel = 2.0 * N * N * N / BenchSeconds(t0) / 1e9;
+        printf("  %6d %14.2f %16.2f %16.2f %8.1fx %8.2fx\n", N, naive, blocked, parallel, blocked / naive, parallel / blocked);
+    }
+
+    // Task B : һвⵥ̻߳׼Уλһ, ڶֱûĻ׼
+    HeadlessSink sink;
+    g_sink = &sink;
+    TaskMatrix task(quick ? 512 : 1024);
+    for (int run = 0; run < 2; ++run) task.Execute();
+    sink.Flush();
+    g_sink = nullptr;
+    const string& log = sink.View(SinkChannelId::Log);
+    for (size_t at = log.find("B: Calc finished"); at != string::npos; at = log.find("B: Calc finished", at + 1))
+        printf("  TaskMatrix: %s\n", log.substr(at, log.find('\r', at) - at).c_str());
+}
+
+// --- stats: ʽͳԭȵɨ, Լ Task E ʽģʽ ( + ͳ) ---
+static void BenchStats(bool quick) {
+    const size_t N = quick ? 20000000 : 200000000;
+    const size_t KEPT = 10000000; // ɨҪȫ, ֻô
+    printf("\n[stats] samples in [0, 100]: mean, variance, min, max, 101-bin histogram\n");
+    vector<int> block(StreamingStats::BLOCK);
+    FastRng rng(1);
+
+    vector<int> all(KEPT);
+    rng.FillInt(all.data(), all.size(), 0, 100);
+    auto t0 = BenchClock::now();
+    double sum = 0;
+    int lo = INT_MAX, hi = INT_MIN;
+    uint64_t hist[StreamingStats::HIST_BINS] = {};
+    for (int x : all) { sum += x; lo = min(lo, x); hi = max(hi, x); ++hist[x]; }
+    double mean = sum / (double)all.size(), var = 0;
+    for (int x : all) var += (x - mean) * (x - mean);
+    var /= (double)all.size();
+    double twoPassRate = all.size() / BenchSeconds(t0);
+    vector<int>().swap(all);
+
+    StreamingStats stats;
+    rng.FillInt(block.data(), block.size(), 0, 100);
+    t0 = BenchClock::now();
+    for (size_t done = 0; done < N; done += block.size()) stats.AddBlock(block.data(), block.size());
+    double statRate = N / BenchSeconds(t0);
+
+    HeadlessSink sink;
+    g_sink = &sink;
+    TaskStats(N).Execute();
+    sink.Flush();
+    g_sink = nullptr;
+    const string& log = sink.View(SinkChannelId::Log);
+    size_t at = log.rfind("E: Streamed");
+
+    // ߶ֱͼλ, ֱ֤ͼȷʵ˼
+    auto median = [](auto&& bin, uint64_t n) {
+        uint64_t seen = 0;
+        int v = 0;
+        while (v < StreamingStats::HIST_BINS - 1 && (seen += bin(v)) < (n + 1) / 2) ++v;
+        return v;
+    };
+    printf("  two-pass over vector<int> (old)   %8.1f M/s over %zu samples, %zu MB held (var %.1f, range %d..%d, median %d)\n",
+        twoPassRate / 1e6, KEPT, KEPT * sizeof(int) >> 20, var, lo, hi, median([&](int v) { return hist[v]; }, KEPT));
+    printf("  StreamingStats::AddBlock          %8.1f M/s over %zu samples, %zu bytes state (var %.1f, range %d..%d, median %d)\n",
+        statRate / 1e6, N, sizeof(StreamingStats), stats.Variance(), stats.Min(), stats.Max(), median([&](int v) { return stats.Bin(v); }, stats.Count()));
+    if (at != string::npos) printf("  TaskStats: %s\n", log.substr(at, log.find('\r', at) - at).c_str());
+}
+
+// --- rng: ׼ mt19937  FastRng ( / ), ʵ ---
+static void BenchRng(bool quick) {
+    const size_t N = quick ? 20000000 : 200000000;
+    printf("\n[rng] %zu draws each\n", N);
+    printf("  %-40s %10s %10s\n", "generator", "M/s", "vs mt19937");
+    long long check = 0;
+    auto run = [&](const char* name, double base, auto&& body) {
+        auto t0 = BenchClock::now();
+        body();
+        double rate = N / BenchSeconds(t0);
+        if (base > 0) printf("  %-40s %10.1f %9.1fx\n", name, rate / 1e6, rate / base);
+        else printf("  %-40s %10.1f %10s\n", name, rate / 1e6, "-");
+        return rate;
+    };
+
+    mt19937 mt(1);
+    uniform_int_distribution<int> dist(0, 100);
+    uniform_real_distribution<double> real(0.0, 10.0);
+    double mtInt = run("mt19937 + uniform_int_distribution", 0, [&] { for (size_t i = 0; i < N; ++i) check += dist(mt); });
+    double mtReal = run("mt19937 + uniform_real_distribution", 0, [&] { for (size_t i = 0; i < N; ++i) check += (long long)real(mt); });
+
+    FastRng rng(1);
+    vector<int> ints(StreamingStats::BLOCK);
+    vector<double> reals(StreamingStats::BLOCK);
+    run("FastRng::UniformInt", mtInt, [&] { for (size_t i = 0; i < N; ++i) check += rng.UniformInt(0, 100); });
+    run("FastRng::FillInt (4096 per call)", mtInt, [&] {
+        for (size_t done = 0; done < N; done += ints.size()) { rng.FillInt(ints.data(), ints.size(), 0, 100); check += ints[0]; }
+    });
+    run("FastRng::FillReal (4096 per call)", mtReal, [&] {
+        for (size_t done = 0; done < N; done += reals.size()) { rng.FillReal(reals.data(), reals.size(), 0.0, 10.0); check += (long long)reals[0]; }
+    });
+    printf("  (checksum %lld)\n", check);
+}
+
+// --- report: ݴÿݱĶѷ ---
+static void BenchReport(bool quick) {
+    const int REPS = quick ? 20000 : 200000;
+    printf("\n[report] data-board report formatting, %d reports each\n", REPS);
+    printf("  %-28s %14s %16s %10s\n", "report", "reports/s", "allocs/report", "bytes");
+
+    AlignedMatrix A(200, 200);
+    FastRng rng(3);
+    rng.FillReal(A.Data(), 200 * 200, 0.0, 9.9);
+    int nums[1000];
+    rng.FillInt(nums, 1000, 0, 100);
+
+    auto run = [&](const char* name, auto&& format) {
+        size_t bytes = format(0).size(); // Ԥ: ݵ̬
+        uint64_t a0 = t_benchAllocs;
+        auto t0 = BenchClock::now();
+        for (int i = 0; i < REPS; ++i) bytes = format(i).size();
+        double secs = BenchSeconds(t0);
+        printf("  %-28s %14.0f %16.3f %10zu\n", name, REPS / secs, (double)(t_benchAllocs - a0) / REPS, bytes);
+    };
+    run("Task B matrix preview", [&](int i) -> const string& { return TaskMatrix::FormatPreview(A, i, 12345.678); });
+    run("Task E data matrix (1000)", [&](int) -> const string& { return TaskStats::FormatTable(nums, 1000); });
+}
+
+// ϳɵıԴ: ıʽĿѹ, С [minBytes, maxBytes] ֮
+static uint64_t BenchMakeTree(const fs::path& root, size_t files, size_t minBytes, size_t maxBytes, size_t perDir, uint64_t seed) {
+    static const char WORDS[] = "lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod tempor 0123456789\n";
+    FastRng rng(seed);
+    fs::create_directories(root);
+    uint64_t total = 0;
+    string buf;
+    for (size_t i = 0; i < files; ++i) {
+        fs::path dir = root / ("d" + to_string(i / perDir));
+        if (i % perDir == 0) fs::create_directories(dir);
+        size_t size = minBytes + (maxBytes > minBytes ? (size_t)rng.Next() % (maxBytes - minBytes + 1) : 0);
+        buf.resize(size);
+        for (size_t k = 0; k < size; ++k) buf[k] = WORDS[rng.Next() % (sizeof(WORDS) - 1)];
+        ofstream(dir / ("f" + to_string(i) + ".txt"), ios::binary).write(buf.data(), (streamsize)size);
+        total += size;
+    }
+    return total;
+}
+
+// --- backup:  ZIP ȥؿ, ϳĿ¼ϸĶԼ 1% ļǰһ ---
+static void BenchBackup(bool quick) {
+    fs::path dir = fs::temp_directory_path() / "scheduler_bench" / "backup";
+    fs::remove_all(dir);
+    size_t files = quick ? 1000 : 4000;
+    uint64_t bytes = BenchMakeTree(dir / "src", files, 4 * 1024, 124 * 1024, 200, 15);
+    int threads = max(1, (int)thread::hardware_concurrency());
+    printf("\n[backup] synthetic tree: %zu files, %.1f MB, %d thread(s)\n", files, bytes / 1048576.0, threads);
+
+    // ֿ
+    {
+        vector<uint8_t> data(64 << 20);
+        FastRng rng(5);
+        rng.Fill((uint64_t*)data.data(), data.size() / 8);
+        size_t chunks = 0;
+        auto t0 = BenchClock::now();
+        for (size_t off = 0; off < data.size(); ++chunks) off += GearChunker::Cut(data.data() + off, data.size() - off);
+        double secs = BenchSeconds(t0);
+        printf("  GearChunker::Cut: %.0f MB/s, %zu chunks (avg %.1f KB)\n", data.size() / 1048576.0 / secs, chunks, data.size() / 1024.0 / chunks);
+    }
+
+    auto zipRun = [&](const char* label, const string& name) {
+        ZipResult z = ZipWriter::Write(dir / name, SourceScanner::Walk(dir / "src", threads), ZipMethod::Deflate, threads);
+        printf("  %-26s %8.1f ms  %7.1f MB/s  %.1f -> %.1f MB\n", label, z.seconds * 1000, z.MBps(), z.rawBytes / 1048576.0, z.zipBytes / 1048576.0);
+    };
+    BackupStore store(dir / "store");
+    auto incRun = [&](const char* label, const string& name) {
+        BackupResult r = store.Backup(dir / "src", name, threads);
+        printf("  %-26s %8.1f ms  %5zu changed file(s), %.1f MB read, %.1f MB stored\n", label, r.seconds * 1000, r.changedFiles,
+            r.scannedBytes / 1048576.0, r.storedBytes / 1048576.0);
+        return r;
+    };
+
+    zipRun("full zip, run 1", "full1.zip");
+    incRun("incremental, run 1 (empty)", "s1");
+
+    // ĶԼ 1% ļ: ĩβ׷һ
+    FastRng rng(16);
+    size_t touched = max<size_t>(1, files / 100);
+    for (size_t k = 0; k < touched; ++k) {
+        size_t i = (size_t)rng.Next() % files;
+        ofstream(dir / "src" / ("d" + to_string(i / 200)) / ("f" + to_string(i) + ".txt"), ios::binary | ios::app) << "changed " << k << "\n";
+    }
+    printf("  -- appended to %zu file(s) --\n", touched);
+    zipRun("full zip, run 2", "full2.zip");
+    BackupResult r2 = incRun("incremental, run 2", "s2");
+
+    uint64_t zipDisk = fs::file_size(dir / "full1.zip") + fs::file_size(dir / "full2.zip"), storeDisk = 0;
+    for (auto& e : fs::recursive_directory_iterator(dir / "store"))
+        if (e.is_regular_file()) storeDisk += e.file_size();
+    printf("  disk after two runs: zips %.1f MB, chunk store %.1f MB\n", zipDisk / 1048576.0, storeDisk / 1048576.0);
+
+    BackupResult r = store.Restore("s1", dir / "restore", threads);
+    printf("  %-26s %8.1f ms  %5zu file(s), %.1f MB\n", "restore snapshot s1", r.seconds * 1000, r.files, r.totalBytes / 1048576.0);
+
+    // У鰴 256 KB ʽ, ÿ̵߳Ļн, ļС޹
+    auto verify = [&](const char* label, VerifyResult v) {
+        printf("  verify %-19s %8.1f ms  %7.1f MB/s  %zu file(s), %.1f MB, %zu mismatch(es)\n", label, v.seconds * 1000, v.MBps(), v.files,
+            v.bytes / 1048576.0, v.mismatches);
+    };
+    verify("zip (checksum)", BackupVerifier::VerifyZip(dir / "full2.zip", dir / "src", VerifyMode::Checksum, threads));
+    verify("zip (compare)", BackupVerifier::VerifyZip(dir / "full2.zip", dir / "src", VerifyMode::Compare, threads));
+    verify("changed (checksum)", BackupVerifier::VerifyFiles(store, r2.changed, dir / "src", VerifyMode::Checksum, threads));
+    verify("snapshot (checksum)", BackupVerifier::VerifySnapshot(store, "s2", dir / "src", VerifyMode::Checksum, threads));
+    verify("snapshot (compare)", BackupVerifier::VerifySnapshot(store, "s2", dir / "src", VerifyMode::Compare, threads));
+    fs::remove_all(dir);
+}
+
+// --- ingest: Ŀ¼ + ȡˮ; Сļļ ---
+static void BenchIngest(bool quick) {
+    fs::path dir = fs::temp_directory_path() / "scheduler_bench" / "ingest";
+    fs::remove_all(dir);
+    int threads = max(1, (int)thread::hardware_concurrency());
+    int dflt = FileIngest::DefaultReaders(threads);
+    printf("\n[ingest] read every file of a tree (warm page cache), %d CPU(s), default %d reader(s)\n", threads, dflt);
+    printf("  MB/s for a plain sequential loop and for FileIngest with 0 (inline), 1 and 4 reader threads\n");
+    printf("  %-18s %8s %8s %9s %9s %9s %9s %9s\n", "tree", "files", "MB", "walk ms", "seq", "inline", "1 reader", "4 readers");
+
+    struct Tree { const char* name; size_t files, minB, maxB; };
+    Tree trees[] = {
+        { "small files", quick ? (size_t)20000 : (size_t)100000, 256, 2048 },
+        { "few large files", 4, quick ? (size_t)(32 << 20) : (size_t)(256 << 20), quick ? (size_t)(32 << 20) : (size_t)(256 << 20) },
+    };
+    for (auto& t : trees) {
+        fs::path root = dir / t.name;
+        BenchMakeTree(root, t.files, t.minB, t.maxB, 1000, 17);
+
+        auto t0 = BenchClock::now();
+        auto list = SourceScanner::Walk(root, threads);
+        double walkMs = BenchSeconds(t0) * 1000;
+        uint64_t total = 0;
+        for (auto& f : list) total += f.size;
+
+        // ÿַʽȡõһ, Դӿջ忪ʼ, ̳һַʽķ
+        auto best = [&](auto run) {
+            double mbps = 0;
+            for (int k = 0; k < 3; ++k) {
+                vector<uint8_t> buf;
+                auto t1 = BenchClock::now();
+                run(buf);
+                mbps = max(mbps, total / 1048576.0 / BenchSeconds(t1));
+            }
+            return mbps;
+        };
+        // : ߳ ifstream 
+        double seq = best([&](vector<uint8_t>& buf) {
+            for (auto& f : list) {
+                ifstream in(f.source, ios::binary);
+                buf.resize((size_t)f.size);
+                in.read((char*)buf.data(), (streamsize)f.size);
+            }
+        });
+        auto pipe = [&](int readers) {
+            return best([&](vector<uint8_t>& buf) {
+                FileIngest ingest(list, readers, 64 << 20);
+                for (size_t i = 0; i < list.size(); ++i) ingest.Take(i, buf);
+            });
+        };
+        double p0 = pipe(0), p1 = pipe(1), p4 = pipe(4);
+        printf("  %-18s %8zu %8.1f %9.1f %9.0f %9.0f %9.0f %9.0f\n", t.name, list.size(), total / 1048576.0, walkMs, seq, p0, p1, p4);
+    }
+    fs::remove_all(dir);
+}
+
+// --- http: ػ 1k ӳ ---
+static void BenchHttp(bool quick) {
+    const int CONCURRENT = 1000;
+    const int ROUNDS = quick ? 5 : 20;
+    LoopbackHttpServer server(1024);
+    HttpClient& client = HttpClient::Instance();
+    HttpClientOptions opt;
+    printf("\n[http] loopback server, 1 KB body, %d concurrent GETs x %d rounds (%zu conns x %zu pipelined per host)\n",
+        CONCURRENT, ROUNDS, opt.maxConnsPerHost, opt.maxPipeline);
+
+    vector<double> lat;
+    lat.reserve((size_t)CONCURRENT * ROUNDS);
+    int failures = 0;
+    mutex m;
+    condition_variable cv;
+    HttpClientStats s0 = client.Stats();
+    auto t0 = BenchClock::now();
+    for (int r = 0; r < ROUNDS; ++r) {
+        int left = CONCURRENT;
+        for (int i = 0; i < CONCURRENT; ++i)
+            client.Get(server.Url("/item/" + to_string(i)), chrono::milliseconds(10000), [&](HttpResponse& resp) {
+                lock_guard<mutex> lk(m);
+                if (resp.status == 200) lat.push_back(resp.latencyMs); else ++failures;
+                if (--left == 0) cv.notify_all();
+            });
+        unique_lock<mutex> lk(m);
+        cv.wait(lk, [&] { return left == 0; });
+    }
+    double secs = BenchSeconds(t0);
+    HttpClientStats s1 = client.Stats();
+    double p50 = BenchPercentile(lat, 0.50), p99 = BenchPercentile(lat, 0.99);
+    printf("  %.0f requests/s, latency p50 %.2f ms, p99 %.2f ms, max %.2f ms, %d failure(s), %llu connect(s)\n",
+        (double)CONCURRENT * ROUNDS / secs, p50, p99, lat.empty() ? 0.0 : lat.back(), failures, (unsigned long long)(s1.connects - s0.connects));
+
+}
+
+// --- cache: 󻺴; ˳ѯͬһԴ, Լʱ LRU ̭ ---
+static void BenchCache(bool quick) {
+    const int POLLS = quick ? 50 : 200;
+    LoopbackHttpServer big(64 * 1024);
+    HttpClient& client = HttpClient::Instance();
+    printf("\n[cache] polling 64 KB resources one at a time, %d polls per row\n", POLLS);
+    printf("  %-30s %12s %10s %10s %6s %6s %9s\n", "mode", "KB received", "mean ms", "p99 ms", "hits", "misses", "evictions");
+
+    // urls Դ; cache ΪʱֱӾ HttpClient
+    auto run = [&](const char* label, HttpCache* cache, int urls) {
+        vector<double> polls;
+        HttpClientStats b0 = client.Stats();
+        for (int i = 0; i < POLLS; ++i) {
+            promise<double> done;
+            auto cb = [&done](HttpResponse& resp) { done.set_value(resp.status == 200 ? resp.latencyMs : -1.0); };
+            string url = big.Url("/poll/" + to_string(i % urls));
+            if (cache) cache->Get(url, chrono::milliseconds(5000), cb);
+            else client.Get(url, chrono::milliseconds(5000), cb);
+            polls.push_back(done.get_future().get());
+        }
+        HttpClientStats b1 = client.Stats();
+        HttpCacheStats cs = cache ? cache->Stats() : HttpCacheStats();
+        double mean = 0;
+        for (double v : polls) mean += v;
+        printf("  %-30s %12.1f %10.3f %10.3f %6llu %6llu %9llu\n", label, (b1.bytesIn - b0.bytesIn) / 1024.0, mean / POLLS,
+            BenchPercentile(polls, 0.99), (unsigned long long)cs.hits, (unsigned long long)cs.misses, (unsigned long long)cs.evictions);
+    };
+    run("direct, 1 url", nullptr, 1);
+    HttpCache one(8 << 20);
+    run("HttpCache 8 MB, 1 url", &one, 1);
+    // 8  64 KB Դѯ, ֻŵ 4  (Ϊ 1/4):  LRU ÿζѱ̭, ȫδ
+    HttpCache small(256 << 10);
+    run("HttpCache 256 KB, 8 urls", &small, 8);
+    HttpCache fits(1 << 20);
+    run("HttpCache 1 MB, 8 urls", &fits, 8);
+}
+
+// --- jitter: FixedDelay  FixedRate ƫ, Լ FixedRate ٺܲԵı ---
+static void BenchJitter(bool quick) {
+    const int INTERVAL = 20;
+    const int WORK_US = 5000;
+    int seconds = quick ? 1 : 3;
+    TaskScheduler& sched = TaskScheduler::Instance();
+    printf("\n[jitter] periodic task every %d ms doing %d ms of work, %d s per mode\n", INTERVAL, WORK_US / 1000, seconds);
+    printf("  %-12s %8s %16s %14s %12s\n", "mode", "runs", "mean period ms", "drift ms", "sd ms");
+    for (PeriodMode mode : { PeriodMode::FixedDelay, PeriodMode::FixedRate }) {
+        mutex m;
+        vector<SchedClock::time_point> starts;
+        TaskSpec spec;
+        spec.task = make_shared<BenchTask>("bench: periodic", [&] {
+            { lock_guard<mutex> lk(m); starts.push_back(SchedClock::now()); }
+            BenchBusy(chrono::microseconds(WORK_US));
+        });
+        spec.intervalMs = INTERVAL;
+        spec.mode = mode;
+        int id = sched.AddTasks({ spec });
+        this_thread::sleep_for(chrono::seconds(seconds));
+        BenchRevoke(id);
+
+        lock_guard<mutex> lk(m);
+        JitterStats j;
+        for (size_t i = 1; i < starts.size(); ++i) j.Add(chrono::duration<double, milli>(starts[i] - starts[i - 1]).count());
+        double drift = starts.size() > 1 ? chrono::duration<double, milli>(starts.back() - starts.front()).count() - INTERVAL * (starts.size() - 1.0) : 0;
+        printf("  %-12s %8zu %16.3f %14.1f %12.3f\n", mode == PeriodMode::FixedRate ? "FixedRate" : "FixedDelay", starts.size(), j.mean, drift, j.StdDev());
+    }
+
+    // : FixedRate ĵ 5 пס STALL_MS, ڼԼ STALL_MS / INTERVAL 
+    const int STALL_MS = 200;
+    printf("  FixedRate, run #5 stalls %d ms (%d periods missed)\n", STALL_MS, STALL_MS / INTERVAL - 1);
+    printf("  %-12s %8s %10s %22s\n", "overrun", "runs", "expected", "runs in 5 ms after stall");
+    for (MissedRunPolicy policy : { MissedRunPolicy::FireOnce, MissedRunPolicy::FireAll, MissedRunPolicy::Skip }) {
+        mutex m;
+        vector<SchedClock::time_point> starts;
+        SchedClock::time_point stallEnd{};
+        TaskSpec spec;
+        spec.task = make_shared<BenchTask>("bench: stalled", [&] {
+            size_t k;
+            { lock_guard<mutex> lk(m); k = starts.size(); starts.push_back(SchedClock::now()); }
+            if (k != 4) return;
+            this_thread::sleep_for(chrono::milliseconds(STALL_MS));
+            lock_guard<mutex> lk(m);
+            stallEnd = SchedClock::now();
+        });
+        spec.intervalMs = INTERVAL;
+        spec.mode = PeriodMode::FixedRate;
+        spec.overrun = policy;
+        int id = sched.AddTasks({ spec });
+        this_thread::sleep_for(chrono::seconds(seconds));
+        BenchRevoke(id);
+
+        lock_guard<mutex> lk(m);
+        size_t burst = count_if(starts.begin(), starts.end(), [&](SchedClock::time_point t) {
+            return t >= stallEnd && t < stallEnd + chrono::milliseconds(5);
+        });
+        const char* name = policy == MissedRunPolicy::FireOnce ? "FireOnce" : policy == MissedRunPolicy::FireAll ? "FireAll" : "Skip";
+        printf("  %-12s %8zu %10d %22zu\n", name, starts.size(), seconds * 1000 / INTERVAL, burst);
+    }
+}
+
+// --- lateness: һɷٵֲ; , ߾ȶʱ, ʱһæ ---
+static void BenchLateness(bool quick) {
+    const int TASKS = quick ? 300 : 2000;
+    TaskScheduler& sched = TaskScheduler::Instance();
+    printf("\n[lateness] %d one-shot tasks due 1 ms apart, per wait backend\n", TASKS);
+    struct Mode { const char* name; bool highResolution; int spinUs; };
+    for (Mode mode : { Mode{ "condition variable", false, 0 }, Mode{ "precision timer", true, 0 }, Mode{ "timer + 200 us spin", true, 200 } }) {
+        TimerPrecision p;
+        p.highResolution = mode.highResolution;
+        p.spin = chrono::microseconds(mode.spinUs);
+        sched.SetTimerPrecision(p);
+        sched.ResetLateness();
+        atomic<int> left{ TASKS };
+        auto noop = make_shared<BenchTask>("bench: noop", [&] { --left; });
+        vector<TaskSpec> specs(TASKS);
+        for (int i = 0; i < TASKS; ++i) {
+            specs[i].task = noop;
+            specs[i].delayMs = 20 + i;
+        }
+        sched.AddTasks(specs);
+        while (left > 0) this_thread::sleep_for(chrono::milliseconds(20));
+        printf("  %s: %s\n", mode.name, sched.Lateness().Report().c_str());
+    }
+    sched.SetTimerPrecision(TimerPrecision());
+}
+
+// --- edf: °ȼ޴; ر뿪ȼ (aging) Ա ---
+static void BenchEdf(bool quick) {
+    const int WORKERS = 2;
+    static constexpr int WORK_US = 2000;
+    const int AGING_MS = 500;
+    int seconds = quick ? 3 : 10;
+    TaskScheduler& sched = TaskScheduler::Instance();
+    sched.SetWorkerCount(WORKERS);
+    // ÿ: , , . Լ 3.2  worker, ֻ 2 
+    struct Load { TaskPriority prio; int count, periodMs, deadlineMs; };
+    Load loads[] = {
+        { TaskPriority::Critical, 2, 10, 10 },
+        { TaskPriority::High, 4, 20, 20 },
+        { TaskPriority::Normal, 8, 20, 40 },
+        { TaskPriority::Low, 16, 20, 100 },
+    };
+    printf("\n[edf] overload: %d workers on %u CPU(s), tasks of %d ms, demand ~3.2 workers, %d s per row\n", WORKERS,
+        thread::hardware_concurrency(), WORK_US / 1000, seconds);
+    printf("  runs = periods that ran; skipped = periods that never ran (coalesced, or still overdue when revoked);\n");
+    printf("  missed/with-deadline includes skipped periods whose deadline passed\n");
+    auto work = make_shared<BenchTask>("bench: edf load", [] { BenchBusy(chrono::microseconds(WORK_US)); });
+    for (int agingMs : { 0, AGING_MS }) {
+        sched.SetAgingStep(chrono::milliseconds(agingMs));
+        auto before = sched.Deadlines();
+        vector<TaskSpec> specs;
+        for (auto& l : loads)
+            for (int i = 0; i < l.count; ++i) {
+                TaskSpec s;
+                s.task = work;
+                s.delayMs = i;
+                s.intervalMs = l.periodMs;
+                s.mode = PeriodMode::FixedRate;
+                s.priority = l.prio;
+                s.deadlineMs = l.deadlineMs;
+                specs.push_back(s);
+            }
+        int first = sched.AddTasks(specs);
+        this_thread::sleep_for(chrono::seconds(seconds));
+        for (size_t i = 0; i < specs.size(); ++i) BenchRevoke(first + (int)i);
+        auto after = sched.Deadlines();
+        for (int c = 0; c < PRIORITY_CLASSES; ++c) {
+            after[c].runs -= before[c].runs;
+            after[c].skipped -= before[c].skipped;
+            after[c].withDeadline -= before[c].withDeadline;
+            after[c].missed -= before[c].missed;
+        }
+        printf("  aging %s:\n    %s\n", agingMs ? (to_string(agingMs) + " ms").c_str() : "off", TaskScheduler::FormatDeadlines(after).c_str());
+    }
+    sched.SetAgingStep(TaskScheduler::DEFAULT_AGING_STEP);
+    sched.SetWorkerCount(TaskScheduler::DefaultWorkerCount());
+}
+
+// --- batch:  AddTask һ AddTasks ---
+static void BenchBatch(bool quick) {
+    const int N = quick ? 20000 : 100000;
+    TaskScheduler& sched = TaskScheduler::Instance();
+    printf("\n[batch] submitting %d tasks (due in 1 h)\n", N);
+    auto noop = make_shared<BenchTask>("bench: batch", [] {});
+    vector<TaskSpec> specs(N);
+    for (auto& s : specs) { s.task = noop; s.delayMs = 3600 * 1000; }
+
+    auto t0 = BenchClock::now();
+    for (auto& s : specs) sched.AddTask(s);
+    double loop = N / BenchSeconds(t0);
+    sched.ClearAllTasks();
+
+    t0 = BenchClock::now();
+    sched.AddTasks(specs);
+    double batch = N / BenchSeconds(t0);
+    sched.ClearAllTasks();
+    printf("  AddTask loop %12.0f tasks/s\n  AddTasks     %12.0f tasks/s (%.1fx)\n", loop, batch, batch / loop);
+}
+
+static int RunBench(const vector<string>& args) {
+    struct Bench { const char* name; void (*run)(bool); };
+    static const Bench BENCHES[] = {
+        { "heap", BenchTimers }, { "exec", BenchExecutor }, { "log", BenchLog }, { "sink", BenchSink },
+        { "gemm", BenchGemm }, { "stats", BenchStats }, { "rng", BenchRng }, { "report", BenchReport },
+        { "backup", BenchBackup }, { "ingest", BenchIngest }, { "http", BenchHttp },
+        { "cache", BenchCache }, { "jitter", BenchJitter }, { "lateness", BenchLateness },
+        { "edf", BenchEdf }, { "batch", BenchBatch },
+    };
+    bool quick = false;
+    vector<string> names;
+    for (auto& a : args) {
+        if (a == "--quick") quick = true;
+        else names.push_back(a);
+    }
+    for (auto& n : names)
+        if (none_of(begin(BENCHES), end(BENCHES), [&](const Bench& b) { return n == b.name; })) {
+            fprintf(stderr, "unknown benchmark: %s (available:", n.c_str());
+            for (auto& b : BENCHES) fprintf(stderr, " %s", b.name);
+            fprintf(stderr, ")\n");
+            return 2;
+        }
+    for (auto& b : BENCHES)
+        if (names.empty() || find(names.begin(), names.end(), b.name) != names.end()) b.run(quick);
+    TaskScheduler::Instance().Stop();
+    return 0;
+}
+#endif
+
+int main(int argc, char** argv) {
+#ifdef SCHEDULER_BENCH
+    if (argc > 1 && string(argv[1]) == "bench") return RunBench(vector<string>(argv + 2, argv + argc));
+#endif
+
+    int seconds = 10;
+    vector<TaskSpec> specs;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) { seconds = atoi(argv[++i]); continue; }
+        TaskSpec spec;
+        if (!ParseTaskArg(arg, spec)) {
+            fprintf(stderr, "usage: %s [--seconds N] TASK...  (TASK = A-F or A+[@delayMs][/intervalMs], or G[@delayMs][/intervalMs]:command)\n", argv[0]);
+#ifdef SCHEDULER_BENCH
+            fprintf(stderr, "       %s bench [NAME...] [--quick]\n", argv[0]);
+#endif
+            return 2;
+        }
+        specs.push_back(move(spec));
+    }
+
+    ConsoleSink sink;
+    g_sink = &sink;
+    TaskScheduler& sched = TaskScheduler::Instance();
+    sched.AddTasks(specs);
+
+    auto end = chrono::steady_clock::now() + chrono::seconds(seconds);
+    while (chrono::steady_clock::now() < end) {
+        this_thread::sleep_for(chrono::milliseconds(SINK_REFRESH_MS));
+        sink.Flush();
+    }
+    sched.Stop();
+    sink.Flush();
+    g_sink = nullptr;
+    return 0;
+}
+#endif